@@ -0,0 +1,336 @@
+#ifndef SYNCRING_H
+#define SYNCRING_H
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstring>
+
+#include <Common/allocator.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#include <immintrin.h>
+#define SYNC_RING_RELAX()	_mm_pause()
+#else
+#define SYNC_RING_RELAX()	std::this_thread::yield()
+#endif
+
+#define SYNC_RING_SPIN_COUNT		2000 // polls before the consumer parks (0: park immediately, default on a single core)
+
+
+// Bounded lock-free ring for a single producer and a single consumer thread (pop is also safe from a second consumer)
+template <typename T>
+class SpscRing
+{
+public:
+    SpscRing() : mask(0), head(0), tail(0) {}
+
+public:
+    void resize(size_t n)
+    {
+        size_t capacity = 1;
+        while (capacity < n) capacity <<= 1;
+        slots.assign(capacity, T());
+        mask = capacity - 1;
+        head.store(0); tail.store(0);
+    }
+
+    bool push(const T& item) // producer only
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask)
+            return false;
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item)
+    {
+        size_t h = head.load(std::memory_order_acquire);
+        T value;
+        do
+        {
+            if (tail.load(std::memory_order_acquire) == h)
+                return false;
+            value = slots[h & mask];
+        } while (!head.compare_exchange_weak(h, h + 1, std::memory_order_acq_rel));
+        item = value;
+        return true;
+    }
+
+    bool empty() const { return tail.load(std::memory_order_acquire) == head.load(std::memory_order_acquire); }
+    int size() const { return (int)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire)); }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head; // written by the consumer
+    alignas(64) std::atomic<size_t> tail; // written by the producer
+};
+
+
+// Buffer hand-off between two threads: owns the free list (consumer -> producer) and the ready list (producer -> consumer)
+template <typename T>
+class SyncRing
+{
+public:
+    SyncRing() : spin_count(std::thread::hardware_concurrency() > 1 ? SYNC_RING_SPIN_COUNT : 0), high_water(0), numa_node(-1), n_buffer(0), is_object(false), parked(false), stopped(false) {}
+    ~SyncRing() { deallocate_queue_buffer(); }
+
+private: // Not to call copy constrcutor and copy assignment operator
+    SyncRing(const SyncRing&);
+    SyncRing& operator=(const SyncRing&);
+
+public:
+    void allocate_queue_buffer(int width, int height, int n)
+    {
+        deallocate_queue_buffer();
+        resize(n);
+        np::frame_allocator::pool pool(n, numa_node); // the buffers share one slab
+        for (int i = 0; i < n_buffer; i++)
+        {
+            blocks.push_back(np::frame_allocator::allocate(width * height * sizeof(T))); // zeroed & pre-faulted
+            T* buffer = static_cast<T*>(blocks.back().get());
+            buffers.push_back(buffer);
+            free_list.push(buffer);
+        }
+    }
+
+    template <typename... Args>
+    void allocate_queue_object(int n, Args... args) // buffers of a record type (T(args...))
+    {
+        deallocate_queue_buffer();
+        resize(n);
+        is_object = true;
+        np::frame_allocator::pool pool(n, numa_node); // the frames of the records share one slab
+        for (int i = 0; i < n_buffer; i++)
+        {
+            T* buffer = new T(args...);
+            buffers.push_back(buffer);
+            free_list.push(buffer);
+        }
+    }
+
+    void deallocate_queue_buffer()
+    {
+        if (is_object)
+            for (size_t i = 0; i < buffers.size(); i++)
+                delete buffers.at(i);
+        buffers.clear();
+        blocks.clear();
+        n_buffer = 0;
+    }
+
+public: // Producer side
+    T* get_buffer() // a free buffer to fill (nullptr if the consumer holds all of them)
+    {
+        T* buffer = nullptr;
+        if (free_list.pop(buffer))
+        {
+            int n = in_use();
+            if (n > high_water) high_water = n;
+        }
+        return buffer;
+    }
+
+    T* wait_buffer(int timeout_ms) // a free buffer to fill, waiting for the consumer (nullptr on timeout)
+    {
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        T* buffer;
+        while ((buffer = get_buffer()) == nullptr)
+        {
+            if (std::chrono::steady_clock::now() > deadline)
+                break;
+            std::this_thread::yield();
+        }
+        return buffer;
+    }
+
+    T* take_oldest() // the oldest buffer not yet taken by the consumer (its frame is discarded)
+    {
+        T* buffer = nullptr;
+        ready_list.pop(buffer);
+        return buffer;
+    }
+
+    void push(T* buffer) // hand a filled buffer to the consumer
+    {
+        ready_list.push(buffer);
+        wake();
+    }
+
+public: // Consumer side
+    void bind_consumer() // run the calling (consumer) thread on the node of the buffers
+    {
+        if (numa_node >= 0)
+            np::frame_allocator::bind_thread(numa_node);
+    }
+
+    T* pop() // next filled buffer (nullptr once stopped and drained)
+    {
+        T* buffer = nullptr;
+
+        // 1. Spin
+        for (int i = 0; i < spin_count; i++)
+        {
+            if (ready_list.pop(buffer)) return buffer;
+            if (stopped.load() && ready_list.empty()) { stopped.store(false); return nullptr; }
+            SYNC_RING_RELAX();
+        }
+
+        // 2. Park
+        std::unique_lock<std::mutex> lock(mtx);
+        parked.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        while (!ready_list.pop(buffer))
+        {
+            if (stopped.load() && ready_list.empty()) { stopped.store(false); buffer = nullptr; break; }
+            cond.wait(lock);
+        }
+        parked.store(false);
+
+        return buffer;
+    }
+
+    void return_buffer(T* buffer) // give a consumed buffer back to the producer
+    {
+        free_list.push(buffer);
+    }
+
+public: // Any thread
+    void stop() // the consumer gets nullptr after the buffers already pushed
+    {
+        stopped.store(true);
+        wake();
+    }
+
+    void reset() // every buffer back to the free list, not stopped (only while neither side is running)
+    {
+        free_list.resize(n_buffer);
+        ready_list.resize(n_buffer);
+        for (size_t i = 0; i < buffers.size(); i++)
+            free_list.push(buffers.at(i));
+        stopped.store(false);
+        parked.store(false);
+        high_water = 0;
+    }
+
+    int capacity() const { return n_buffer; }
+    int queued() const { return ready_list.size(); } // pushed, not yet taken by the consumer
+    int in_use() const { return n_buffer - free_list.size(); } // queued or held by the consumer
+
+private:
+    void resize(int n)
+    {
+        n_buffer = n;
+        is_object = false;
+        free_list.resize(n);
+        ready_list.resize(n);
+        stopped.store(false);
+        high_water = 0;
+    }
+
+    void wake()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked.load())
+        {
+            { std::unique_lock<std::mutex> lock(mtx); } // the consumer is inside wait() once the lock is free
+            cond.notify_one();
+        }
+    }
+
+public:
+    int spin_count;
+    int high_water; // maximum number of buffers in use (updated by the producer)
+    int numa_node; // NUMA node of the buffers allocated next (-1: node of the allocating thread)
+
+private:
+    int n_buffer;
+    bool is_object;
+    std::vector<T*> buffers;
+    std::vector<std::shared_ptr<void>> blocks; // memory of the plain buffers
+
+    SpscRing<T*> free_list;
+    SpscRing<T*> ready_list;
+
+    std::atomic<bool> parked;
+    std::atomic<bool> stopped;
+    std::mutex mtx;
+    std::condition_variable cond;
+};
+
+
+// In-order consumer of N rings dealt in turn (the item of sequence number i, T::frame_index, is pushed to ring i % N):
+// one pending item per ring, the numbers dropped before this stage are skipped
+template <typename T, int N>
+class SyncReorder
+{
+public:
+    explicit SyncReorder(SyncRing<T>* _rings) : rings(_rings) { reset(); }
+
+private: // Not to call copy constrcutor and copy assignment operator
+    SyncReorder(const SyncReorder&);
+    SyncReorder& operator=(const SyncReorder&);
+
+public:
+    void reset() // before the first pop of a run
+    {
+        frame_seq = 0;
+        memset(pending, 0, sizeof(pending));
+        memset(finished, 0, sizeof(finished));
+    }
+
+    T* pop(int& ring) // next item in order, taken from rings[ring] (nullptr once every ring is stopped and drained)
+    {
+        T* item = nullptr;
+        while (item == nullptr)
+        {
+            int n_finished = 0;
+            for (int i = 0; i < N; i++)
+                if (finished[i]) n_finished++;
+            if (n_finished == N)
+                break;
+
+            // Number 'frame_seq' can only come from the ring it was dealt to
+            int k = frame_seq % N;
+            if (!finished[k] && (pending[k] == nullptr))
+            {
+                pending[k] = rings[k].pop();
+                if (pending[k] == nullptr)
+                {
+                    finished[k] = true;
+                    continue;
+                }
+            }
+            if (!finished[k] && (pending[k]->frame_index < frame_seq))
+            {
+                // An item behind the sequence can never be taken: give it back rather than stalling its producer
+                rings[k].return_buffer(pending[k]);
+                pending[k] = nullptr;
+                continue;
+            }
+            if (!finished[k] && (pending[k]->frame_index == frame_seq))
+            {
+                item = pending[k];
+                pending[k] = nullptr;
+                ring = k;
+            }
+            frame_seq++; // otherwise the number was dropped before this stage
+        }
+        return item;
+    }
+
+private:
+    SyncRing<T>* rings;
+    int frame_seq; // sequence number expected next
+    T* pending[N]; // popped from its ring, ahead of the sequence
+    bool finished[N];
+};
+
+#endif // SYNCRING_H
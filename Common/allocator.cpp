@@ -0,0 +1,290 @@
+#include "allocator.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <sched.h>
+#include <cstdio>
+#include <cstdlib>
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED				1 // <numaif.h> (libnuma is not required for the raw system call)
+#endif
+#endif
+
+namespace np {
+
+static thread_local frame_allocator::pool *building = nullptr; // innermost pool being built on this thread
+
+static size_t round_up(size_t size, size_t unit) { return (size + unit - 1) / unit * unit; }
+
+
+std::shared_ptr<void> frame_allocator::allocate(int size)
+{
+	// 1. Small buffers: cache-line aligned heap
+	if (size < FRAME_ALLOC_MIN_SIZE)
+	{
+		void *ptr = nullptr;
+#if defined(_WIN32)
+		ptr = _aligned_malloc(size, FRAME_ALLOC_ALIGN);
+#else
+		if (posix_memalign(&ptr, FRAME_ALLOC_ALIGN, size)) ptr = nullptr;
+#endif
+		if (!ptr) throw std::bad_alloc();
+		memset(ptr, 0, size);
+#if defined(_WIN32)
+		return std::shared_ptr<void>(ptr, _aligned_free);
+#else
+		return std::shared_ptr<void>(ptr, ::free);
+#endif
+	}
+
+	// 2. Frames of a pool: carved from its slab
+	if (building)
+		return building->carve(size);
+
+	// 3. Single frame buffers: pages straight from the system
+	return map_frame(size, -1);
+}
+
+std::shared_ptr<void> frame_allocator::map_frame(size_t size, int numa_node)
+{
+	if ((numa_node < 0) && (options().numa_node >= 0))
+		numa_node = options().numa_node;
+
+	size_t bytes = 0;
+	void *ptr = map_pages(size, bytes, numa_node);
+	if (!ptr) throw std::bad_alloc();
+
+	// Pre-fault every page here rather than on the first frame (first touch also places the pages on Linux)
+	memset(ptr, 0, bytes);
+	if (options().lock) lock_pages(ptr, bytes);
+
+	return std::shared_ptr<void>(ptr, [bytes](void *p) { unmap_pages(p, bytes); });
+}
+
+
+frame_allocator::pool::pool(int n, int _numa_node) : n_frame(n), numa_node(_numa_node), outer(building)
+{
+	building = this;
+}
+
+frame_allocator::pool::~pool()
+{
+	building = outer;
+}
+
+std::shared_ptr<void> frame_allocator::pool::carve(size_t size)
+{
+	// Slab of this frame size with a frame left (a new slab for n frames otherwise)
+	slab *s = nullptr;
+	for (size_t i = 0; i < slabs.size(); i++)
+		if ((slabs.at(i).frame_size == size) && (slabs.at(i).used < n_frame))
+			s = &slabs.at(i);
+
+	if (!s)
+	{
+		slab new_slab;
+		new_slab.frame_size = size;
+		new_slab.stride = round_up(size, FRAME_ALLOC_ALIGN);
+		new_slab.block = map_frame(new_slab.stride * n_frame, numa_node);
+		new_slab.used = 0;
+		slabs.push_back(new_slab);
+		s = &slabs.back();
+	}
+
+	// The frame keeps the whole slab alive
+	char *frame = static_cast<char *>(s->block.get()) + s->stride * s->used++;
+	return std::shared_ptr<void>(s->block, frame);
+}
+
+
+#if defined(_WIN32)
+
+static bool enable_large_pages()
+{
+	// Large pages require SeLockMemoryPrivilege (granted by the local security policy)
+	static int enabled = -1;
+	if (enabled < 0)
+	{
+		enabled = 0;
+		HANDLE token;
+		if (OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+		{
+			TOKEN_PRIVILEGES tp;
+			tp.PrivilegeCount = 1;
+			tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+			if (LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid))
+				if (AdjustTokenPrivileges(token, FALSE, &tp, 0, nullptr, nullptr) && (GetLastError() == ERROR_SUCCESS))
+					enabled = 1;
+			CloseHandle(token);
+		}
+	}
+	return enabled == 1;
+}
+
+int frame_allocator::numa_nodes()
+{
+	ULONG highest = 0;
+	if (!GetNumaHighestNodeNumber(&highest))
+		return 1;
+	return (int)highest + 1;
+}
+
+int frame_allocator::current_node()
+{
+	PROCESSOR_NUMBER proc;
+	USHORT node = 0;
+	GetCurrentProcessorNumberEx(&proc);
+	if (!GetNumaProcessorNodeEx(&proc, &node))
+		return -1;
+	return node;
+}
+
+bool frame_allocator::bind_thread(int numa_node)
+{
+	GROUP_AFFINITY affinity;
+	if (!GetNumaNodeProcessorMaskEx((USHORT)numa_node, &affinity))
+		return false;
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+}
+
+void *frame_allocator::map_pages(size_t size, size_t &bytes, int numa_node)
+{
+	void *ptr = nullptr;
+	if (numa_node < 0) numa_node = current_node();
+	DWORD node = (numa_node < 0) ? NUMA_NO_PREFERRED_NODE : (DWORD)numa_node;
+
+	size_t large = GetLargePageMinimum();
+	if (options().huge_pages && large && enable_large_pages())
+	{
+		bytes = round_up(size, large);
+		ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+	}
+	if (!ptr)
+	{
+		SYSTEM_INFO info;
+		GetSystemInfo(&info);
+		bytes = round_up(size, info.dwPageSize);
+		ptr = VirtualAllocExNuma(GetCurrentProcess(), nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+	}
+	return ptr;
+}
+
+void frame_allocator::lock_pages(void *ptr, size_t bytes)
+{
+	VirtualLock(ptr, bytes); // fails quietly beyond the working set quota
+}
+
+void frame_allocator::unmap_pages(void *ptr, size_t bytes)
+{
+	(void)bytes;
+	VirtualFree(ptr, 0, MEM_RELEASE);
+}
+
+#else
+
+// CPU list of sysfs ("0-3,8-11") into an affinity mask (false if the file is missing)
+static bool read_cpulist(const char *path, cpu_set_t *set, int *highest)
+{
+	FILE *fp = fopen(path, "r");
+	if (!fp) return false;
+
+	if (set) CPU_ZERO(set);
+	int first, last;
+	char sep;
+	while (fscanf(fp, "%d", &first) == 1)
+	{
+		last = first;
+		if ((fscanf(fp, "%c", &sep) == 1) && (sep == '-'))
+		{
+			if (fscanf(fp, "%d", &last) != 1) last = first;
+			if (fscanf(fp, "%c", &sep) != 1) sep = '\n';
+		}
+		for (int i = first; i <= last; i++)
+			if (set && (i < CPU_SETSIZE)) CPU_SET(i, set);
+		if (highest && (last > *highest)) *highest = last;
+		if (sep != ',') break;
+	}
+	fclose(fp);
+
+	return true;
+}
+
+int frame_allocator::numa_nodes()
+{
+	int highest = 0;
+	if (!read_cpulist("/sys/devices/system/node/online", nullptr, &highest))
+		return 1;
+	return highest + 1;
+}
+
+int frame_allocator::current_node()
+{
+	unsigned int cpu = 0, node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+		return -1;
+	return (int)node;
+}
+
+bool frame_allocator::bind_thread(int numa_node)
+{
+	char path[64];
+	sprintf(path, "/sys/devices/system/node/node%d/cpulist", numa_node);
+
+	cpu_set_t set;
+	if (!read_cpulist(path, &set, nullptr))
+		return false;
+	return sched_setaffinity(0, sizeof(cpu_set_t), &set) == 0;
+}
+
+void *frame_allocator::map_pages(size_t size, size_t &bytes, int numa_node)
+{
+	void *ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+	if (options().huge_pages)
+	{
+		bytes = round_up(size, FRAME_ALLOC_HUGE_PAGE);
+		ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	}
+#endif
+	if (ptr == MAP_FAILED)
+	{
+		bytes = round_up(size, (size_t)sysconf(_SC_PAGESIZE));
+		ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+			return nullptr;
+#ifdef MADV_HUGEPAGE
+		if (options().huge_pages)
+			madvise(ptr, bytes, MADV_HUGEPAGE); // transparent huge pages when no pool is reserved
+#endif
+	}
+
+	// A given node is preferred before the first touch (otherwise the pre-faulting thread places the pages)
+	if ((numa_node >= 0) && (numa_node < 8 * (int)sizeof(unsigned long)) && (numa_nodes() > 1))
+	{
+		unsigned long mask = 1UL << numa_node;
+		syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED, &mask, 8 * sizeof(unsigned long), 0);
+	}
+
+	return ptr;
+}
+
+void frame_allocator::lock_pages(void *ptr, size_t bytes)
+{
+	mlock(ptr, bytes); // fails quietly beyond RLIMIT_MEMLOCK
+}
+
+void frame_allocator::unmap_pages(void *ptr, size_t bytes)
+{
+	munmap(ptr, bytes);
+}
+
+#endif
+
+} // namespace np
@@ -2,6 +2,13 @@
 #define NUMCPP_ALLOCATOR_H_
 
 #include <memory>
+#include <new>
+#include <cstring>
+#include <vector>
+
+#define FRAME_ALLOC_MIN_SIZE		(64 * 1024) // smaller buffers are taken from the heap
+#define FRAME_ALLOC_ALIGN			64 // heap buffer & pooled frame alignment (cache line)
+#define FRAME_ALLOC_HUGE_PAGE		(2 * 1024 * 1024) // huge page size (Linux)
 
 namespace np {
 
@@ -14,8 +21,70 @@ struct heap_allocator
 
 	static void free(void *ptr)
 	{
-		delete[] ptr;
+		delete[] static_cast<char *>(ptr);
+	}
+};
+
+
+struct frame_allocator_options
+{
+	bool huge_pages = true; // large (Windows) or huge (Linux) pages when the system grants them
+	bool lock = true; // keep regular pages resident (best effort, large pages are never paged out)
+	int numa_node = -1; // preferred NUMA node of the buffers without one of their own (-1: node of the allocating thread)
+};
+
+// Allocator for large frame buffers: page-aligned, optionally huge-page backed, pre-faulted and NUMA-placed
+// (the system calls live in allocator.cpp)
+struct frame_allocator
+{
+	static frame_allocator_options &options()
+	{
+		static frame_allocator_options opt;
+		return opt;
 	}
+
+	static std::shared_ptr<void> allocate(int size); // zeroed (carved from the pool being built on this thread, if any)
+
+	// Buffer pool of n frames: while it is alive, the first n frames of each size allocated on this thread
+	// are carved from one slab (a single huge-page rounding, pre-fault & NUMA placement for the whole pool)
+	class pool
+	{
+	public:
+		explicit pool(int n, int numa_node = -1);
+		~pool();
+
+	private: // Not to call copy constrcutor and copy assignment operator
+		pool(const pool&);
+		pool& operator=(const pool&);
+
+	public:
+		std::shared_ptr<void> carve(size_t size);
+
+	private:
+		struct slab
+		{
+			std::shared_ptr<void> block;
+			size_t frame_size, stride;
+			int used;
+		};
+
+		int n_frame;
+		int numa_node;
+		std::vector<slab> slabs; // one per frame size
+		pool *outer; // pool being built before this one on the thread
+	};
+
+	// NUMA
+	static int numa_nodes(); // nodes of the system (1 without NUMA)
+	static int current_node(); // node of the calling thread
+	static bool bind_thread(int numa_node); // run the calling thread on the processors of a node only
+
+private:
+	static void *map_pages(size_t size, size_t &bytes, int numa_node); // numa_node -1: node of the calling thread
+	static void lock_pages(void *ptr, size_t bytes);
+	static void unmap_pages(void *ptr, size_t bytes);
+
+	static std::shared_ptr<void> map_frame(size_t size, int numa_node); // zeroed, pre-faulted & locked
 };
 
 } // namespace np
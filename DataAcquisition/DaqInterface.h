@@ -0,0 +1,38 @@
+#ifndef DAQ_INTERFACE_H
+#define DAQ_INTERFACE_H
+
+#include <Common/array.h>
+#include <Common/callback.h>
+
+#define MAX_MSG_LENGTH 2000
+
+
+// Acquisition backend: delivers frames of (nChannels * nScans) x nAlines samples through DidAcquireData from its own thread
+class DaqInterface
+{
+public:
+	explicit DaqInterface() : nChannels(1), nScans(512), nAlines(1024), _running(false) {}
+	virtual ~DaqInterface() {}
+
+	// callbacks
+	callback2<int, const np::Uint16Array2 &> DidAcquireData;
+	callback<void> DidStopData;
+	callback2<const char*, bool> SendStatusMessage;
+
+public:
+	virtual bool set_init() = 0;
+
+	virtual bool startAcquisition() = 0;
+	virtual void stopAcquisition() = 0;
+
+	// Boot-time DMA buffer (only for the boards that need one)
+	virtual int getBootTimeBuffer(int idx) { (void)idx; return 0; }
+	virtual bool setBootTimeBuffer(int idx, int buffer_size) { (void)idx; (void)buffer_size; return true; }
+
+public:
+	int nChannels, nScans, nAlines;
+
+	bool _running;
+};
+
+#endif // DAQ_INTERFACE_H
@@ -2,31 +2,74 @@
 #include "DataAcquisition.h"
 
 #include <DataAcquisition/SignatecDAQ/SignatecDAQ.h>
+#include <DataAcquisition/SimulatorDAQ/SimulatorDAQ.h>
+#include <DataAcquisition/ReplayDAQ/ReplayDAQ.h>
 #include <DataAcquisition/FLImProcess/FLImProcess.h>
 
 
 DataAcquisition::DataAcquisition(Configuration* pConfig)
-    : m_pDaq(nullptr), m_pFLIm(nullptr)
+    : m_pDaq(nullptr)
 {
     m_pConfig = pConfig;
 
-    // Create SignatecDAQ object
-    m_pDaq = new SignatecDAQ;
+    // Create DAQ object (by the acquisition backend)
+    if (m_pConfig->daqBackend == DAQ_BACKEND_SIMULATOR)
+    {
+        SimulatorDAQ* pSimulator = new SimulatorDAQ;
+        pSimulator->Bg = m_pConfig->flimBg;
+        pSimulator->nCh = m_pConfig->flimChannels;
+        for (int i = 0; i < 4; i++)
+        {
+            pSimulator->ChStartInd[i] = m_pConfig->flimChStartInd[i];
+            if (i != 0)
+            {
+                pSimulator->DelayOffset[i - 1] = m_pConfig->flimDelayOffset[i - 1];
+                pSimulator->Lifetime[i - 1] = m_pConfig->simLifetime[i - 1];
+            }
+        }
+        pSimulator->Jitter = m_pConfig->simJitter;
+        pSimulator->Noise = m_pConfig->simNoise;
+        pSimulator->Saturation = m_pConfig->simSaturation;
+        pSimulator->DaqRate = m_pConfig->simDaqRate;
+        m_pDaq = pSimulator;
+    }
+    else if (m_pConfig->daqBackend == DAQ_BACKEND_REPLAY)
+    {
+        ReplayDAQ* pReplay = new ReplayDAQ;
+        pReplay->FilePath = m_pConfig->replayPath;
+        pReplay->Speed = m_pConfig->replaySpeed;
+        pReplay->Loop = m_pConfig->replayLoop;
+        m_pDaq = pReplay;
+    }
+    else
+    {
+        SignatecDAQ* pSignatec = new SignatecDAQ;
+        pSignatec->BootTimeBufIdx = PX14_BOOTBUF_IDX;
+        pSignatec->VoltRange2 = PX14_VOLTAGE_RANGE;
+        m_pDaq = pSignatec;
+    }
     m_pDaq->DidStopData += [&]() { m_pDaq->_running = false; };
 
-    // Create FLIm process object
-    m_pFLIm = new FLImProcess;
-	m_pFLIm->SendStatusMessage += [&](const char* msg) { m_pConfig->msgHandle(msg); };
-	m_pFLIm->_resize.SendStatusMessage += [&](const char* msg) { m_pConfig->msgHandle(msg); };
-    m_pFLIm->setParameters(m_pConfig);
-    m_pFLIm->_resize(np::Uint16Array2(m_pConfig->flimScans, m_pConfig->flimAlines), m_pFLIm->_params);
-    m_pFLIm->loadMaskData();
+    // Create FLIm process objects (one per processing worker)
+    for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+    {
+        m_pFLIm[i] = new FLImProcess;
+        if (i == 0)
+        {
+            m_pFLIm[i]->SendStatusMessage += [&](const char* msg) { m_pConfig->msgHandle(msg); };
+            m_pFLIm[i]->_resize.SendStatusMessage += [&](const char* msg) { m_pConfig->msgHandle(msg); };
+        }
+        m_pFLIm[i]->setParameters(m_pConfig);
+        m_pFLIm[i]->_resize(np::Uint16Array2(m_pConfig->flimScans, m_pConfig->flimAlines), m_pFLIm[i]->_params);
+        m_pFLIm[i]->loadMaskData();
+    }
 }
 
 DataAcquisition::~DataAcquisition()
 {
     if (m_pDaq) delete m_pDaq;
-    if (m_pFLIm) delete m_pFLIm;
+    for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+        if (m_pFLIm[i]) delete m_pFLIm[i];
 }
 
 
@@ -38,8 +81,6 @@ bool DataAcquisition::InitializeAcquistion()
     // Parameter settings for DAQ & Axsun Capture
     m_pDaq->nScans = m_pConfig->flimScans;
     m_pDaq->nAlines = m_pConfig->flimAlines;
-    m_pDaq->BootTimeBufIdx = PX14_BOOTBUF_IDX;
-    m_pDaq->VoltRange2 = PX14_VOLTAGE_RANGE;
 
     // Initialization for DAQ
     if (!(m_pDaq->set_init()))
@@ -67,6 +108,9 @@ void DataAcquisition::StopAcquisition()
 {
     // Stop thread
     m_pDaq->stopAcquisition();
+
+    // The consumers are stopped once the last frame is delivered
+    DidStopFlimData();
 }
 
 
@@ -88,7 +132,7 @@ void DataAcquisition::ConnectDaqAcquiredFlimData(const std::function<void(int, c
 
 void DataAcquisition::ConnectDaqStopFlimData(const std::function<void(void)> &slot)
 {
-    m_pDaq->DidStopData += slot;
+    DidStopFlimData += slot;
 }
 
 void DataAcquisition::ConnectDaqSendStatusMessage(const std::function<void(const char*, bool)> &slot)
@@ -8,7 +8,7 @@
 #include <Common/array.h>
 #include <Common/callback.h>
 
-class SignatecDAQ;
+class DaqInterface;
 class FLImProcess;
 
 
@@ -21,7 +21,7 @@ public:
     virtual ~DataAcquisition();
 
 public:
-    inline FLImProcess* getFLIm() const { return m_pFLIm; }
+    inline FLImProcess* getFLIm(int worker = 0) const { return m_pFLIm[worker]; } // 0: primary (calibration & status messages)
 
 public:
     bool InitializeAcquistion();
@@ -40,8 +40,10 @@ public:
 private:
 	Configuration* m_pConfig;
 
-    SignatecDAQ* m_pDaq;
-    FLImProcess* m_pFLIm;
+    DaqInterface* m_pDaq;
+    FLImProcess* m_pFLIm[FLIM_PROCESSING_WORKERS];
+
+    callback<void> DidStopFlimData; // after the acquisition thread is joined (no more frames)
 };
 
 #endif // DATAACQUISITION_H
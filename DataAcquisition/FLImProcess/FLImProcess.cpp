@@ -2,7 +2,7 @@
 #include "FLImProcess.h"
 
 
-FLImProcess::FLImProcess()
+FLImProcess::FLImProcess() : calib_copy(false)
 {
 }
 
@@ -16,14 +16,45 @@ void FLImProcess::operator() (FloatArray2& intensity, FloatArray2& mean_delay, F
     // 1. Crop and resize pulse data
     _resize(pulse, _params);
 
-    // 2. Get intensity
-    _intensity(_resize);
-    memcpy(intensity, _intensity.intensity, sizeof(float) * _intensity.intensity.length());
+    // 2. Get intensity & lifetime (one parallel pass over A-lines, written directly into the caller's buffers)
+    _intensity.intensity = intensity;
+    _lifetime.mean_delay = mean_delay;
+    _lifetime.lifetime = lifetime;
+    _lifetime(_resize, _params, _intensity);
+}
 
-    // 3. Get lifetime
-    _lifetime(_resize, _params, intensity);
-    memcpy(mean_delay, _lifetime.mean_delay, sizeof(float) * _lifetime.mean_delay.length());
-    memcpy(lifetime, _lifetime.lifetime, sizeof(float) * _lifetime.lifetime.length());
+void FLImProcess::operator() (FlimFrameResult& result, Uint16Array2& pulse)
+{
+    // 1. Compute into the planes of the result
+    FloatArray2 intensity = result.intensityView();
+    FloatArray2 mean_delay = result.meanDelayView();
+    FloatArray2 lifetime = result.lifetimeView();
+    (*this)(intensity, mean_delay, lifetime, pulse);
+
+    // 2. Saturated A-line channels
+    result.saturated = 0;
+    for (int j = 0; j < _params.n_ch; j++)
+        for (int i = 0; i < _resize.saturated.size(0); i++)
+            if (_resize.saturated(i, j) > 0)
+                result.saturated++;
+
+    // 3. Keep a copy for the calibration dialog (the result buffer is recycled)
+    if (calib_copy)
+    {
+        std::unique_lock<std::mutex> lock(calib_mtx);
+        calib.copyFrom(result);
+
+        bool spline = _resize.spline_view && (_resize.ext_src.length() > 0);
+        int len = !spline ? (int)_resize.nx : _resize.ext_src.size(0);
+        if (calib_pulse.length() != len)
+        {
+            calib_pulse = FloatArray(len);
+            calib_mask = FloatArray(len);
+        }
+        memcpy(calib_pulse, !spline ? _resize.pulse(0) : &_resize.ext_src(0, 0), sizeof(float) * len);
+        ippsSet_32f(1.0f, calib_mask, len);
+        memcpy(calib_mask, _resize.pMask, sizeof(float) * _resize.nx);
+    }
 }
 
 
@@ -44,6 +75,27 @@ void FLImProcess::setParameters(Configuration* pConfig)
              _params.delay_offset[i - 1] = pConfig->flimDelayOffset[i - 1];
     }
     _params.ch_start_ind[4] = _params.ch_start_ind[3] + FLIM_CH_START_5;
+    _params.n_ch = pConfig->flimChannels;
+
+    _params.upsample_mode = pConfig->flimUpsampleMode;
+    _params.md_tolerance = pConfig->flimMeanDelayTolerance;
+}
+
+void FLImProcess::syncParameters(const FLImProcess& primary)
+{
+    // Follow the parameters of the primary object (changed by FLIm calibration dlg)
+    const FLIM_PARAMS& src = primary._params;
+
+    bool changed = (_params.bg != src.bg) || (_params.n_ch != src.n_ch) || (_params.upsample_mode != src.upsample_mode)
+        || (_params.md_tolerance != src.md_tolerance)
+        || memcmp(_params.ch_start_ind, src.ch_start_ind, sizeof(src.ch_start_ind))
+        || memcmp(_params.delay_offset, src.delay_offset, sizeof(src.delay_offset));
+
+    if (changed)
+    {
+        _params = src;
+        _resize.initiated = false; // re-initialized with the next frame
+    }
 }
 
 void FLImProcess::saveMaskData(QString maskpath)
@@ -15,6 +15,9 @@
 #ifndef FLIM_SPLINE_FACTOR
 #error("FLIM_SPLINE_FACTOR is not defined for FLIM processing.");
 #endif
+#ifndef FLIM_SPLINE_BAND
+#error("FLIM_SPLINE_BAND is not defined for FLIM processing.");
+#endif
 #ifndef INTENSITY_THRES
 #error("INTENSITY_THRES is not defined for FLIM processing.");
 #endif
@@ -23,6 +26,8 @@
 #include <vector>
 #include <utility>
 #include <cmath>
+#include <cfloat>
+#include <mutex>
 
 #include <QString>
 #include <QFile>
@@ -35,10 +40,56 @@
 
 #include <mkl_df.h>
 
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include <Common/array.h>
 #include <Common/callback.h>
 using namespace np;
 
+#include "FlimFrameResult.h"
+
+
+#define UPSAMPLE_MKL_SPLINE			0 // cubic spline by MKL data fitting tasks
+#define UPSAMPLE_SPLINE_MATRIX		1 // pre-computed banded spline operator
+#define UPSAMPLE_FUSED				2 // spline & FIR broadening fused into one banded operator
+#define UPSAMPLE_FUSED_ROI			3 // fused operator evaluated on the channel windows only
+
+#define MEAN_DELAY_MAX_ITER			10
+
+#define FLIM_FUSED_BAND				(FLIM_SPLINE_BAND + (GAUSSIAN_FILTER_WIDTH + FLIM_SPLINE_FACTOR - 1) / FLIM_SPLINE_FACTOR)
+
+// AVX2 kernels are built for any x64 target (no /arch:AVX2 for the whole application) and chosen on the CPU at run time
+#if defined(_MSC_VER)
+#define FLIM_TARGET_AVX2 // MSVC emits the intrinsics of any instruction set without /arch
+#else
+#define FLIM_TARGET_AVX2			__attribute__((target("avx2,bmi,popcnt")))
+#endif
+
+
+inline bool flimHasAVX2()
+{
+	// AVX2 with BMI1 & POPCNT, and the YMM state saved by the OS (checked once)
+	static const bool has_avx2 = []() {
+#if defined(_MSC_VER)
+		int r[4];
+		__cpuid(r, 0);
+		if (r[0] < 7) return false;
+		__cpuid(r, 1);
+		if (!(r[2] & (1 << 27)) || !(r[2] & (1 << 23))) return false; // OSXSAVE, POPCNT
+		if ((_xgetbv(0) & 6) != 6) return false; // XMM & YMM state
+		__cpuidex(r, 7, 0);
+		return ((r[1] & (1 << 5)) != 0) && ((r[1] & (1 << 3)) != 0); // AVX2, BMI1
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi") && __builtin_cpu_supports("popcnt");
+#endif
+	}();
+	return has_avx2;
+}
+
 
 struct FLIM_PARAMS
 {
@@ -47,8 +98,14 @@ struct FLIM_PARAMS
     float samp_intv = 1.0f;
     float width_factor = 2.0f;
 
+    int n_ch = 4; // IRF + emission channels (4 or 2)
     int ch_start_ind[5] = { 0, };
     float delay_offset[3] = { 0.0f, };
+
+    int upsample_mode = UPSAMPLE_MKL_SPLINE;
+    float md_tolerance = 0.0f; // mean delay convergence tolerance (up-sampled samples, 0: until the window stops moving)
+
+    int ch_end_ind() const { return ch_start_ind[n_ch - 1] + FLIM_CH_START_5; }
 };
 
 struct FILTER // Gaussian Filtering
@@ -103,84 +160,194 @@ private:
     Ipp32f* pTaps;
 };
 
+struct BANDMATRIX // Banded linear operator (pre-computed up-sampling)
+{
+    BANDMATRIX() :
+        pWeights(nullptr), pStart(nullptr), nrow(0), width(0)
+    {
+    }
+
+    ~BANDMATRIX()
+    {
+        if (pWeights) { ippsFree(pWeights); pWeights = nullptr; }
+        if (pStart) { ippsFree(pStart); pStart = nullptr; }
+    }
+
+    void operator() (Ipp32f* pDst, const Ipp32f* pSrc)
+    {
+        // pDst[r] = sum_k w(k, r) * pSrc[start(r) + k]
+        dispatch(pDst, pSrc, 0.0f);
+    }
+
+    void operator() (Ipp32f* pDst, const Ipp16u* pSrc, Ipp32f bg)
+    {
+        // Same operator on raw samples (BG subtracted at the operator input)
+        dispatch(pDst, pSrc, bg);
+    }
+
+    void initialize(const Ipp32f* pFull, int _nrow, int _ncol, int _width)
+    {
+        // pFull : full operator stored column by column (response of each input sample, _nrow long)
+        nrow = _nrow;
+        width = (_width < _ncol) ? _width : _ncol;
+
+        if (pWeights) { ippsFree(pWeights); pWeights = nullptr; }
+        pWeights = ippsMalloc_32f(nrow * width);
+        if (pStart) { ippsFree(pStart); pStart = nullptr; }
+        pStart = ippsMalloc_32s(nrow);
+
+        for (int r = 0; r < nrow; r++)
+        {
+            // Keep the window of inputs carrying the largest weight
+            Ipp32f energy = 0.0f, max_energy;
+            for (int c = 0; c < width; c++)
+                energy += fabsf(pFull[c * nrow + r]);
+            max_energy = energy; pStart[r] = 0;
+
+            for (int c = width; c < _ncol; c++)
+            {
+                energy += fabsf(pFull[c * nrow + r]) - fabsf(pFull[(c - width) * nrow + r]);
+                if (energy > max_energy)
+                {
+                    max_energy = energy;
+                    pStart[r] = c - width + 1;
+                }
+            }
+
+            for (int k = 0; k < width; k++)
+                pWeights[r * width + k] = pFull[(pStart[r] + k) * nrow + r];
+        }
+    }
+
+private:
+    template <typename T>
+    void dispatch(Ipp32f* pDst, const T* pSrc, Ipp32f bg)
+    {
+        // Fixed-width kernels for the band widths known at compile time
+        switch (width)
+        {
+        case FLIM_SPLINE_BAND: apply<FLIM_SPLINE_BAND>(pDst, pSrc, bg); break;
+        case FLIM_FUSED_BAND: apply<FLIM_FUSED_BAND>(pDst, pSrc, bg); break;
+        default: apply<0>(pDst, pSrc, bg);
+        }
+    }
+
+    template <int W, typename T>
+    void apply(Ipp32f* pDst, const T* pSrc, Ipp32f bg)
+    {
+        const int len = W ? W : width;
+        for (int r = 0; r < nrow; r++)
+        {
+            const Ipp32f* w = pWeights + r * len;
+            const T* y = pSrc + pStart[r];
+
+            Ipp32f acc = 0.0f;
+            for (int k = 0; k < len; k++)
+                acc += w[k] * ((Ipp32f)y[k] - bg);
+            pDst[r] = acc;
+        }
+    }
+
+private:
+    Ipp32f* pWeights;
+    Ipp32s* pStart;
+    int nrow;
+    int width;
+};
+
 struct RESIZE
 {
 public:
-    RESIZE() : scoeff(nullptr), pSeq(nullptr), pMask(nullptr), nx(-1), initiated(false)
+    RESIZE() : scoeff(nullptr), tasks(nullptr), pRaw(nullptr), pMask(nullptr), pShift(nullptr), nx(-1), ny(0), initiated(false), n_ch(4),
+        upsample_mode(UPSAMPLE_MKL_SPLINE), spline_view(false), pulse_view(false)
     {
     }
 
     ~RESIZE()
     {
+        deleteTasks();
         if (scoeff) delete[] scoeff;
-        if (pSeq) ippsFree(pSeq);
         if (pMask) ippsFree(pMask);
+        if (pShift) ippsFree(pShift);
     }
 
     void operator() (const Uint16Array2 &src, const FLIM_PARAMS &pParams)
     {
         // 0. Initialize
-        int _nx = pParams.ch_start_ind[4] - pParams.ch_start_ind[0];
-        if ((nx != _nx) || !initiated)
-            initialize(pParams, _nx, FLIM_SPLINE_FACTOR, src.size(1));
-
-        // 1. Crop ROI
-        int offset = pParams.ch_start_ind[0]; // + pParams.pre_trig;
-        ippiConvert_16u32f_C1R(&src(offset, 0), sizeof(uint16_t) * src.size(0),
-                               crop_src.raw_ptr(), sizeof(float) * crop_src.size(0), srcSize);
-
-        // 2. Determine whether saturated
-        ippsThreshold_32f(crop_src.raw_ptr(), sat_src.raw_ptr(), sat_src.length(), 65531, ippCmpLess);
-        ippsSubC_32f_I(65531, sat_src.raw_ptr(), sat_src.length());
+        int _nx = pParams.ch_end_ind() - pParams.ch_start_ind[0];
+        if ((nx != _nx) || !initiated || (upsample_mode != pParams.upsample_mode) || (n_ch != pParams.n_ch))
+            initialize(pParams, _nx, FLIM_SPLINE_FACTOR, src.size(1), src.size(0));
+
+        // Specialization for the channel count
+        if (n_ch == 2)
+            process<2>(src, pParams);
+        else
+            process<4>(src, pParams);
+    }
+
+    template <int N>
+    void process(const Uint16Array2 &src, const FLIM_PARAMS &pParams)
+    {
+        // Up-sampled pulse of the spline view is allocated on demand in the fused modes (first A-line only)
+        bool view = spline_view;
+        if (view && (ext_src.length() == 0))
+            ext_src = std::move(FloatArray2((int)nsite, 1));
+
+        // 1. Crop ROI (with margins for jitter compensation, kept in 16-bit form in the source frame)
+        int offset = pParams.ch_start_ind[0] - jitter_pre; // + pParams.pre_trig;
+        int ncrop = mask_src.size(0);
+        int irf_wlen = pParams.ch_start_ind[1] - pParams.ch_start_ind[0];
         int roi_len = (int)round(pulse_roi_length / ActualFactor);
-        for (int i = 1; i < 4; i++)
-        {
-            for (int j = 0; j < ny; j++)
-            {
-                saturated(j, i) = 0;
-                offset = pParams.ch_start_ind[i] - pParams.ch_start_ind[0];
-                ippsSum_32f(&sat_src(offset, j), roi_len, &saturated(j, i), ippAlgHintFast);
-            }
-        }
+        float sat_level = pParams.bg + 31000.0f; // saturation level (31000 above BG)
+        int thres = (sat_level < 65535.0f) ? (int)sat_level : 65535;
+
+        pRaw = &src(offset, 0);
+        raw_stride = src.size(0);
+        bg = pParams.bg;
 
-        // 3. BG subtraction
-        ippsSubC_32f_I(pParams.bg, crop_src.raw_ptr(), crop_src.length());
+        // Float pulse is required for the MKL tasks (every A-line) and the pulse view of the calibration dialog (first A-line only)
+        bool to_float = (upsample_mode == UPSAMPLE_MKL_SPLINE);
 
-        /// 4. Remove artifact manually (smart artifact removal method)
+        /// 2. Remove artifact manually (smart artifact removal method)
         ///int ch_ind4[5]; memcpy(ch_ind4, pParams.ch_start_ind, sizeof(int) * 5);
         ///int dc_determine_len = 5;
 
 		// Parallel-for loop
-        memcpy(mask_src.raw_ptr(), crop_src.raw_ptr(), sizeof(float) * mask_src.length());
         tbb::parallel_for(tbb::blocked_range<size_t>(0, (size_t)ny),
             [&](const tbb::blocked_range<size_t>& r) {
             for (size_t i = r.begin(); i != r.end(); ++i)
             {
-				float max_val; //int max_ind;
-				
-				// 4. Jitter compensation
-				int cpos = 6, rpos = 6;
-				int irf_wlen = pParams.ch_start_ind[1] - pParams.ch_start_ind[0];
-				ippsMaxIndx_32f(&mask_src(0, (int)i), irf_wlen, &max_val, &cpos);
-
-				int offset = cpos - rpos;
-				if (offset < 0) offset += mask_src.size(0);
-				std::rotate(&mask_src(0, (int)i), &mask_src(offset, (int)i), &mask_src(mask_src.size(0) - 1, (int)i)); //////////////////////////////////////////////////
+				const Ipp16u* raw = pRaw + i * raw_stride;
 				
+				// 3. Jitter compensation (IRF peak aligned to ref_pos by shifting the view into the cropped pulse)
+				const Ipp16u* irf = raw + jitter_pre;
+				int cpos = MaxIndex_16u(irf, irf_wlen);
+
+				int shift = cpos - ref_pos;
+				if (shift < -jitter_pre) shift = -jitter_pre;
+				if (shift > jitter_post) shift = jitter_post;
+				pShift[i] = jitter_pre + shift;
+
 				///int end_ind4[4]; memcpy(end_ind4, ch_ind4 + 1, sizeof(int) * 4);
 				///ippsSubC_32s_ISfs(ch_ind4[0], end_ind4, 4, 0);
-				
-				// 5. Determine whether saturated
-				int thres = 31000;
-				ippsThreshold_32f(&mask_src(0, (int)i), &sat_src(0, (int)i), sat_src.size(0), thres, ippCmpLess);
-				ippsSubC_32f_I(thres, &sat_src(0, (int)i), sat_src.size(0));
-				for (int j = 1; j < 4; j++)
+
+				// 4. Determine whether saturated (count of raw samples above the saturation level)
+				saturated((int)i, 0) = 0;
+				for (int j = 1; j < N; j++)
 				{
-					saturated((int)i, j) = 0;
-					offset = pParams.ch_start_ind[j] - pParams.ch_start_ind[0];
-					ippsSum_32f(&sat_src(offset, (int)i), roi_len, &saturated((int)i, j), ippAlgHintFast);
+					int start = pShift[i] + pParams.ch_start_ind[j] - pParams.ch_start_ind[0];
+					saturated((int)i, j) = (float)CountAbove_16u(raw + start, roi_len, thres);
 				}
 
+				// Conversion & BG subtraction (only if the float pulse is needed)
+				if (to_float || (pulse_view && (i == 0)))
+				{
+					ippsConvert_16u32f(raw, &mask_src(0, (int)i), ncrop);
+					ippsSubC_32f_I(pParams.bg, &mask_src(0, (int)i), ncrop);
+				}
+				const Ipp16u* pulse16 = raw + pShift[i];
+				const float* pulse = &mask_src(pShift[i], (int)i);
+
                 // 5. DC level auto-adjustment
 				///for (int ch = 1; ch < 4; ch++)
 				///{
@@ -191,14 +358,30 @@ public:
 				///}
 
                 // 6. Up-sampling by cubic natural spline interpolation
-                DFTaskPtr task1 = nullptr;
-
-                dfsNewTask1D(&task1, nx, x, DF_UNIFORM_PARTITION, 1, &mask_src(0, (int)i), DF_MATRIX_STORAGE_ROWS);
-                dfsEditPPSpline1D(task1, DF_PP_CUBIC, DF_PP_NATURAL, DF_BC_NOT_A_KNOT, 0, DF_NO_IC, 0, scoeff + (int)i * (nx - 1) * DF_PP_CUBIC, DF_NO_HINT);
-                dfsConstruct1D(task1, DF_PP_SPLINE, DF_METHOD_STD);
-                dfsInterpolate1D(task1, DF_INTERP, DF_METHOD_PP, nsite, x, DF_UNIFORM_PARTITION, 1, &dorder,
-                                 DF_NO_APRIORI_INFO, &ext_src(0, (int)i), DF_MATRIX_STORAGE_ROWS, NULL);
-                dfDeleteTask(&task1);
+                if (upsample_mode >= UPSAMPLE_FUSED)
+                {
+                    // Up-sampling & broadening in one pass (ext_src only for the spline view of the first A-line)
+                    if (upsample_mode == UPSAMPLE_FUSED)
+                        _fused(&filt_src(0, (int)i), pulse16, pParams.bg);
+                    else
+                        _fused_roi(&filt_src(0, (int)i), pulse16, pParams.bg);
+                    if (view && (i == 0))
+                        _spline(&ext_src(0, (int)i), pulse16, pParams.bg);
+                    continue;
+                }
+                else if (upsample_mode == UPSAMPLE_SPLINE_MATRIX)
+                {
+                    // Pre-computed banded spline operator
+                    _spline(&ext_src(0, (int)i), pulse16, pParams.bg);
+                }
+                else
+                {
+                    // (the task of each A-line persists across frames, only its data pointer follows the jitter shift)
+                    dfsEditPtr(tasks[i], DF_Y, pulse);
+                    dfsConstruct1D(tasks[i], DF_PP_SPLINE, DF_METHOD_STD);
+                    dfsInterpolate1D(tasks[i], DF_INTERP, DF_METHOD_PP, nsite, x, DF_UNIFORM_PARTITION, 1, &dorder,
+                                     DF_NO_APRIORI_INFO, &ext_src(0, (int)i), DF_MATRIX_STORAGE_ROWS, NULL);
+                }
 
                 // 7. Software broadening by FIR Gaussian filtering
                 _filter(&filt_src(0, (int)i), &ext_src(0, (int)i), (int)i);
@@ -206,63 +389,240 @@ public:
         });
     }
 
-    void initialize(const FLIM_PARAMS& pParams, int _nx, int _upSampleFactor, int _alines)
+    void initialize(const FLIM_PARAMS& pParams, int _nx, int _upSampleFactor, int _alines, int _scans)
     {
+        /* Release spline tasks bound to the previous buffers */
+        deleteTasks();
+
         /* Parameters */
         nx = _nx; ny = _alines;
+        n_ch = pParams.n_ch;
+        upsample_mode = pParams.upsample_mode;
         upSampleFactor = _upSampleFactor;
         nsite = nx * upSampleFactor;
         ActualFactor = (float)(nx * upSampleFactor - 1) / (float)(nx - 1);
         x[0] = 0.0f; x[1] = (float)nx - 1.0f;
-        srcSize = { (int)nx, (int)ny };
         dorder = 1;
 
+        /* Crop margins for jitter compensation (IRF peak searched in the first channel window) */
+        ref_pos = 6;
+        jitter_pre = (pParams.ch_start_ind[0] < ref_pos) ? pParams.ch_start_ind[0] : ref_pos;
+        jitter_post = pParams.ch_start_ind[1] - pParams.ch_start_ind[0] - 1 - ref_pos;
+        if (jitter_post > _scans - pParams.ch_end_ind()) jitter_post = _scans - pParams.ch_end_ind();
+        if (jitter_post < 0) jitter_post = 0;
+
         /* Find pulse roi length for mean delay calculation */
         for (int i = 0; i < 5; i++)
             ch_start_ind1[i] = (int)round((float)pParams.ch_start_ind[i] * ActualFactor);
+        ch_start_ind1[n_ch] = (int)round((float)pParams.ch_end_ind() * ActualFactor);
 
         int diff_ind[4];
-        for (int i = 0; i < 4; i++)
+        for (int i = 0; i < n_ch; i++)
             diff_ind[i] = ch_start_ind1[i + 1] - ch_start_ind1[i];
 
-        ippsMin_32s(diff_ind, 4, &pulse_roi_length);
+        ippsMin_32s(diff_ind, n_ch, &pulse_roi_length);
+        if (pulse_roi_length > nsite - (ch_start_ind1[n_ch - 1] - ch_start_ind1[0])) // last window within the up-sampled span
+            pulse_roi_length = nsite - (ch_start_ind1[n_ch - 1] - ch_start_ind1[0]);
 		char msg[256];
 		sprintf(msg, "FLIm Initializing... %d", pulse_roi_length);
 		SendStatusMessage(msg);
 
-        /* sequence for mean delay caculation */
-        if (pSeq) { ippsFree(pSeq); pSeq = nullptr; }
-        pSeq = ippsMalloc_32f(pulse_roi_length);
-        ippsVectorSlope_32f(pSeq, pulse_roi_length, 0, 1);
-
         /* mask for removal of rotary junction artifacts */
         if (pMask) { ippsFree(pMask); pMask = nullptr; }
         pMask = ippsMalloc_32f(nx);
         ippsSet_32f(1.0f, pMask, nx);
 
-        /* Array of spline coefficients */
+        /* Per A-line jitter shift of the view into mask_src */
+        if (pShift) { ippsFree(pShift); pShift = nullptr; }
+        pShift = ippsMalloc_32s(ny);
+        ippsSet_32s(jitter_pre, pShift, ny);
+
+        /* Array of spline coefficients (MKL tasks only) */
         if (scoeff) { delete[] scoeff; scoeff = nullptr; }
-        scoeff = new float[ny * (nx - 1) * DF_PP_CUBIC];
+        if (upsample_mode == UPSAMPLE_MKL_SPLINE)
+            scoeff = new float[ny * (nx - 1) * DF_PP_CUBIC];
 
         /* data buffer allocation */
-        crop_src  = std::move(FloatArray2((int)nx, (int)ny));
-        mask_src  = std::move(FloatArray2((int)nx, (int)ny));
-        sat_src   = std::move(FloatArray2((int)nx, (int)ny));
-        ext_src   = std::move(FloatArray2((int)nsite, (int)ny));
-        filt_src  = std::move(FloatArray2((int)nsite, (int)ny));
+        mask_src  = std::move(FloatArray2((int)nx + jitter_pre + jitter_post, (int)ny));
+        if (upsample_mode < UPSAMPLE_FUSED)
+            ext_src   = std::move(FloatArray2((int)nsite, (int)ny));
+        else
+            ext_src   = std::move(FloatArray2()); // spline view only (allocated on demand)
+        if (upsample_mode != UPSAMPLE_FUSED_ROI)
+            filt_src  = std::move(FloatArray2((int)nsite, (int)ny));
+        else
+            filt_src  = std::move(FloatArray2((int)(n_ch * pulse_roi_length), (int)ny)); // channel windows only
 
         saturated = std::move(FloatArray2((int)ny, 4));
         memset(saturated, 0, sizeof(float) * saturated.length());
 
+        /* Data fitting tasks (one persistent task per A-line, not used by the banded modes) */
+        if (upsample_mode == UPSAMPLE_MKL_SPLINE)
+        {
+            tasks = new DFTaskPtr[ny];
+            for (int i = 0; i < ny; i++)
+            {
+                tasks[i] = nullptr;
+                dfsNewTask1D(&tasks[i], nx, x, DF_UNIFORM_PARTITION, 1, &mask_src(jitter_pre, i), DF_MATRIX_STORAGE_ROWS);
+                dfsEditPPSpline1D(tasks[i], DF_PP_CUBIC, DF_PP_NATURAL, DF_BC_NOT_A_KNOT, 0, DF_NO_IC, 0, scoeff + i * (nx - 1) * DF_PP_CUBIC, DF_NO_HINT);
+            }
+        }
+
+        /* Spline operator (interpolation of unit impulses, truncated to FLIM_SPLINE_BAND inputs per output sample) */
+        FloatArray2 eye((int)nx, (int)nx);
+        memset(eye, 0, sizeof(float) * eye.length());
+        for (int i = 0; i < nx; i++)
+            eye(i, i) = 1.0f;
+
+        FloatArray2 impulse_resp((int)nsite, (int)nx);
+        float* icoeff = new float[nx * (nx - 1) * DF_PP_CUBIC];
+
+        DFTaskPtr task1 = nullptr;
+        dfsNewTask1D(&task1, nx, x, DF_UNIFORM_PARTITION, nx, eye.raw_ptr(), DF_MATRIX_STORAGE_ROWS);
+        dfsEditPPSpline1D(task1, DF_PP_CUBIC, DF_PP_NATURAL, DF_BC_NOT_A_KNOT, 0, DF_NO_IC, 0, icoeff, DF_NO_HINT);
+        dfsConstruct1D(task1, DF_PP_SPLINE, DF_METHOD_STD);
+        dfsInterpolate1D(task1, DF_INTERP, DF_METHOD_PP, nsite, x, DF_UNIFORM_PARTITION, 1, &dorder,
+                         DF_NO_APRIORI_INFO, impulse_resp.raw_ptr(), DF_MATRIX_STORAGE_ROWS, NULL);
+        dfDeleteTask(&task1);
+        delete[] icoeff;
+
+        _spline.initialize(impulse_resp.raw_ptr(), nsite, nx, FLIM_SPLINE_BAND);
+
         /* filter coefficient allocation */
         _filter.initialize(GAUSSIAN_FILTER_WIDTH, nsite, ny);
 
+        /* Fused spline & FIR operator (each impulse response broadened by the Gaussian filter) */
+        FloatArray2 fused_resp((int)nsite, (int)nx);
+        for (int i = 0; i < nx; i++)
+            _filter(&fused_resp(0, i), &impulse_resp(0, i), 0);
+        int fused_band = FLIM_SPLINE_BAND + (GAUSSIAN_FILTER_WIDTH + upSampleFactor - 1) / upSampleFactor; // FLIM_FUSED_BAND
+        _fused.initialize(fused_resp.raw_ptr(), nsite, nx, fused_band);
+
+        /* Rows of the fused operator within the channel windows */
+        FloatArray2 roi_resp((int)(n_ch * pulse_roi_length), (int)nx);
+        for (int i = 0; i < nx; i++)
+            for (int j = 0; j < n_ch; j++)
+                memcpy(&roi_resp(j * pulse_roi_length, i), &fused_resp(ch_start_ind1[j] - ch_start_ind1[0], i), sizeof(float) * pulse_roi_length);
+        _fused_roi.initialize(roi_resp.raw_ptr(), n_ch * pulse_roi_length, nx, fused_band);
+
+        /* Intensity weights (ROI sum of the up-sampled pulse as a function of the original samples) */
+        intensity_weight = std::move(FloatArray2((int)nx, 4));
+        memset(intensity_weight, 0, sizeof(float) * intensity_weight.length());
+        for (int i = 0; i < n_ch; i++)
+        {
+            int offset = ch_start_ind1[i] - ch_start_ind1[0];
+            for (int j = 0; j < nx; j++)
+                ippsSum_32f(&impulse_resp(offset, j), pulse_roi_length, &intensity_weight(j, i), ippAlgHintAccurate);
+        }
+
         initiated = true;
     }
 
+    const float* pulse(int aline) const
+    {
+        // Jitter-compensated pulse of each A-line (nx samples, filled for MKL tasks, or for the first A-line with pulse_view)
+        return &mask_src(pShift[aline], aline);
+    }
+
+    Ipp32f dot(const Ipp32f* pWeights, int aline) const
+    {
+        // Inner product of the BG-subtracted, jitter-compensated raw pulse (valid during the current frame)
+        const Ipp16u* y = pRaw + aline * raw_stride + pShift[aline];
+        Ipp32f acc = 0.0f;
+        for (int k = 0; k < nx; k++)
+            acc += pWeights[k] * ((Ipp32f)y[k] - bg);
+        return acc;
+    }
+
+    const float* filtered(int ch, int aline) const
+    {
+        // Start of the filtered pulse of each channel window
+        int offset = (upsample_mode == UPSAMPLE_FUSED_ROI) ? ch * pulse_roi_length : ch_start_ind1[ch] - ch_start_ind1[0];
+        return &filt_src(offset, aline);
+    }
+
+private:
+    static int MaxIndex_16u(const Ipp16u* pSrc, int len)
+    {
+        // Index of the first maximum
+        if (flimHasAVX2())
+            return MaxIndex_16u_AVX2(pSrc, len);
+
+        Ipp16u max_val = 0;
+        for (int k = 0; k < len; k++)
+            if (pSrc[k] > max_val) max_val = pSrc[k];
+        for (int k = 0; k < len; k++)
+            if (pSrc[k] == max_val) return k;
+        return 0;
+    }
+
+    FLIM_TARGET_AVX2 static int MaxIndex_16u_AVX2(const Ipp16u* pSrc, int len)
+    {
+        int k = 0;
+        __m256i vmax = _mm256_setzero_si256();
+        for (; k + 16 <= len; k += 16)
+            vmax = _mm256_max_epu16(vmax, _mm256_loadu_si256((const __m256i*)(pSrc + k)));
+        __m128i vmax8 = _mm_max_epu16(_mm256_castsi256_si128(vmax), _mm256_extracti128_si256(vmax, 1));
+        vmax8 = _mm_xor_si128(_mm_minpos_epu16(_mm_xor_si128(vmax8, _mm_set1_epi16(-1))), _mm_set1_epi16(-1));
+        Ipp16u max_val = (Ipp16u)_mm_extract_epi16(vmax8, 0);
+        for (int j = k; j < len; j++)
+            if (pSrc[j] > max_val) max_val = pSrc[j];
+
+        __m256i vref = _mm256_set1_epi16((short)max_val);
+        for (k = 0; k + 16 <= len; k += 16)
+        {
+            unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)(pSrc + k)), vref));
+            if (mask) return k + (int)(_tzcnt_u32(mask) >> 1);
+        }
+        for (; k < len; k++)
+            if (pSrc[k] == max_val) return k;
+        return 0;
+    }
+
+    static int CountAbove_16u(const Ipp16u* pSrc, int len, int thres)
+    {
+        // Number of samples greater than thres
+        if (thres >= 65535) return 0;
+        if (flimHasAVX2())
+            return CountAbove_16u_AVX2(pSrc, len, thres);
+
+        int n = 0;
+        for (int k = 0; k < len; k++)
+            n += (pSrc[k] > thres);
+        return n;
+    }
+
+    FLIM_TARGET_AVX2 static int CountAbove_16u_AVX2(const Ipp16u* pSrc, int len, int thres)
+    {
+        int n = 0, k = 0;
+        __m256i vth = _mm256_set1_epi16((short)(thres + 1));
+        for (; k + 16 <= len; k += 16)
+        {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(pSrc + k));
+            n += _mm_popcnt_u32((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_max_epu16(v, vth), v))) >> 1;
+        }
+        for (; k < len; k++)
+            n += (pSrc[k] > thres);
+        return n;
+    }
+
+    void deleteTasks()
+    {
+        if (tasks)
+        {
+            for (int i = 0; i < ny; i++)
+                if (tasks[i]) dfDeleteTask(&tasks[i]);
+            delete[] tasks;
+            tasks = nullptr;
+        }
+    }
+
 private:
-    IppiSize srcSize;
     float* scoeff;
+    DFTaskPtr* tasks;
+    const Ipp16u* pRaw; // cropped source frame (valid during the current frame)
+    int raw_stride;
+    Ipp32f bg;
     float x[2];
     MKL_INT dorder;
 
@@ -272,21 +632,29 @@ public:
     MKL_INT nx, ny; // original data length, dimension
     MKL_INT nsite; // interpolated data length
 
+    int n_ch;
     int ch_start_ind1[5];
+    int ref_pos, jitter_pre, jitter_post;
     int upSampleFactor;
     Ipp32f ActualFactor;
     int pulse_roi_length;
 
+    BANDMATRIX _spline;
+    BANDMATRIX _fused;
+    BANDMATRIX _fused_roi;
     FILTER _filter;
 
+    int upsample_mode;
+    bool spline_view; // ext_src of the first A-line is required for display in the fused modes
+    bool pulse_view; // mask_src of the first A-line is required for display in the banded modes
+    FloatArray2 intensity_weight;
+
     FloatArray2 saturated;
 
-    Ipp32f* pSeq;
     Ipp32f* pMask;
+    Ipp32s* pShift;
 
-    FloatArray2 crop_src;
     FloatArray2 mask_src;
-    FloatArray2 sat_src;
     FloatArray2 ext_src;
     FloatArray2 filt_src;
 
@@ -296,94 +664,164 @@ public:
 struct INTENSITY
 {
 public:
-    INTENSITY() : _ny(0) {}
+    INTENSITY() {}
     ~INTENSITY() {}
 
-    void operator() (const RESIZE& resize) // scans x 256 ==> 256 x 4
+    void initialize(const RESIZE& resize) // scans x 256 ==> 256 x 4 (intensity is a view of the caller's buffer)
     {
-        if (_ny != resize.ny)
-        {
-            intensity = FloatArray2(resize.ny, 4);
-            _ny = resize.ny;
-        }
+        // Unused channels are zeroed
+        for (int i = resize.n_ch; i < 4; i++)
+            memset(&intensity(0, i), 0, sizeof(float) * intensity.size(0));
+    }
 
-        int offset;
-        for (int i = 0; i < 4; i++)
+    template <int N>
+    void integrate(const RESIZE& resize, int aline) // called per A-line from the parallel loop of LIFETIME
+    {
+        for (int i = 0; i < N; i++)
         {
-            for (int j = 0; j < intensity.size(0); j++)
+            Ipp32f sum = 0.0f; // NAN;
+            if (resize.saturated(aline, i) < 1)
             {
-				intensity(j, i) = 0.0f; // NAN;
-                if (resize.saturated(j, i) < 1)
+                if (resize.upsample_mode >= UPSAMPLE_FUSED)
+                    sum = resize.dot(&resize.intensity_weight(0, i), aline);
+                else
                 {
-                    offset = resize.ch_start_ind1[i] - resize.ch_start_ind1[0];
-                    ippsSum_32f(&resize.ext_src(offset, j), resize.pulse_roi_length, &intensity(j, i), ippAlgHintAccurate);
+                    int offset = resize.ch_start_ind1[i] - resize.ch_start_ind1[0];
+                    ippsSum_32f(&resize.ext_src(offset, aline), resize.pulse_roi_length, &sum, ippAlgHintAccurate);
                 }
             }
+            intensity(aline, i) = sum;
         }
 
-        for (int i = 0; i < 4; i++)
-            ippsDiv_32f_I(&intensity(0, 0), &intensity(0, 3 - i), intensity.size(0));
+        // Normalization by the IRF channel
+        for (int i = N - 1; i >= 0; i--)
+            intensity(aline, i) /= intensity(aline, 0);
     }
 
 public:
-    int _ny;
     np::FloatArray2 intensity;
 };
 
 struct LIFETIME
 {
 public:
-    LIFETIME() : _ny(0) {}
-    ~LIFETIME() {}
+    LIFETIME() : _ny(0), _len(0), pPrefix(nullptr), pBatch(nullptr), pIter(nullptr)
+    {
+        memset(iter_hist, 0, sizeof(iter_hist));
+    }
 
-    void operator() (const RESIZE& resize, const FLIM_PARAMS& pParams, FloatArray2& intensity)
+    ~LIFETIME()
+    {
+        if (pPrefix) { ippsFree(pPrefix); pPrefix = nullptr; }
+        if (pBatch) { ippsFree(pBatch); pBatch = nullptr; }
+        if (pIter) { ippsFree(pIter); pIter = nullptr; }
+    }
+
+    void operator() (const RESIZE& resize, const FLIM_PARAMS& pParams, INTENSITY& intensity) // mean_delay & lifetime are views of the caller's buffers
     {
         if (_ny != resize.ny)
         {
-            mean_delay = FloatArray2(resize.ny, 4);
-            lifetime = FloatArray2(resize.ny, 3);
             _ny = resize.ny;
+
+            if (pIter) { ippsFree(pIter); pIter = nullptr; }
+            pIter = ippsMalloc_32s(4 * _ny);
+            _len = 0;
+        }
+
+        if (_len != resize.pulse_roi_length)
+        {
+            // Prefix sums of the pulse and of the index-weighted pulse (one pair per A-line)
+            _len = resize.pulse_roi_length;
+            if (pPrefix) { ippsFree(pPrefix); pPrefix = nullptr; }
+            pPrefix = ippsMalloc_64f(2 * (_len + 1) * _ny);
+
+            // A-line interleaved copy of the pulses for the batched width search
+            if (pBatch) { ippsFree(pBatch); pBatch = nullptr; }
+            pBatch = ippsMalloc_32f(8 * _len * ((_ny + 7) / 8));
         }
 		
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, (size_t)resize.ny),
+        intensity.initialize(resize);
+
+        // Specialization for the channel count (unused channels are zeroed)
+        if (resize.n_ch == 2)
+            process<2>(resize, pParams, intensity);
+        else
+            process<4>(resize, pParams, intensity);
+
+        // Iteration count distribution of the mean delay solver
+        memset(iter_hist, 0, sizeof(iter_hist));
+        for (int i = 0; i < _ny; i++)
+            for (int j = 0; j < resize.n_ch; j++)
+                iter_hist[pIter[4 * i + j]]++;
+    }
+
+    template <int N>
+    void process(const RESIZE& resize, const FLIM_PARAMS& pParams, INTENSITY& _intensity)
+    {
+        FloatArray2& intensity = _intensity.intensity;
+
+        for (int j = N; j < 4; j++)
+            memset(&mean_delay(0, j), 0, sizeof(float) * mean_delay.size(0));
+        for (int j = N - 1; j < 3; j++)
+            memset(&lifetime(0, j), 0, sizeof(float) * lifetime.size(0));
+
+        // Parallel-for loop over batches of 8 A-lines
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, (size_t)((_ny + 7) / 8)),
             [&](const tbb::blocked_range<size_t>& r) {
-            for (size_t i = r.begin(); i != r.end(); ++i)
+            for (size_t b = r.begin(); b != r.end(); ++b)
             {
-				for (int j = 0; j < 4; j++)
+				int i0 = 8 * (int)b;
+				int n = (_ny - i0 < 8) ? _ny - i0 : 8;
+				Ipp32s maxIdx[N][8], width[N][8];
+
+				// 1. Get IRF width (A-line batched)
+				for (int j = 0; j < N; j++)
 				{
-					int offset, width, left, maxIdx;
-					float md_temp;
-					offset = resize.ch_start_ind1[j] - resize.ch_start_ind1[0];
-
-					// 1. Get IRF width
-					const float* pulse = &resize.filt_src(offset, (int)i);
-					WidthIndex_32f(pulse, 0.5f, resize.pulse_roi_length, maxIdx, width);
-					roiWidth[j] = (int)round(pParams.width_factor * width);
-					left = (int)floor(roiWidth[j] / 2);
-
-					// 2. Get mean delay of each channel (iterative process)
-					MeanDelay_32f(resize, offset, (int)i, maxIdx, roiWidth[j], left, md_temp);
-					mean_delay((int)i, j) = (md_temp + (float)resize.ch_start_ind1[j]) / resize.ActualFactor;
+					if (n == 8)
+						WidthIndex8_32f(resize.filtered(j, i0), resize.filt_src.size(0), 0.5f, resize.pulse_roi_length, &pBatch[8 * _len * b], maxIdx[j], width[j]);
+					else
+						for (int l = 0; l < n; l++)
+							WidthIndex_32f(resize.filtered(j, i0 + l), 0.5f, resize.pulse_roi_length, maxIdx[j][l], width[j][l]);
 				}
 
-                // 3. Subtract mean delay of IRF to mean delay of each channel
-                for (int j = 0; j < 3; j++)
-                {
-					//if ((!std::isnan(intensity((int)i, j + 1))) && (intensity((int)i, j + 1) > INTENSITY_THRES))
-					//	lifetime((int)i, j) = pParams.samp_intv * (mean_delay((int)i, j + 1) - mean_delay((int)i, 0)) - pParams.delay_offset[j];
-					//else if (std::isnan(intensity((int)i, j + 1)))
-					//	lifetime((int)i, j) = NAN;
-     //               else if (intensity((int)i, j + 1) <= INTENSITY_THRES)
-     //                   lifetime((int)i, j) = 0.0f;
-
-					if ((intensity((int)i, j + 1) > INTENSITY_THRES))
-						lifetime((int)i, j) = pParams.samp_intv * (mean_delay((int)i, j + 1) - mean_delay((int)i, 0)) - pParams.delay_offset[j];
-					else
-						lifetime((int)i, j) = 0.0f; // NAN;
-                }
+				for (int l = 0; l < n; l++)
+				{
+					int i = i0 + l;
+
+					// 2. Get intensity of each channel (normalized by the IRF)
+					_intensity.integrate<N>(resize, i);
+
+					for (int j = 0; j < N; j++)
+					{
+						int left, roi_width;
+						float md_temp;
+
+						roi_width = (int)round(pParams.width_factor * width[j][l]);
+						left = (int)floor(roi_width / 2);
+
+						// 3. Get mean delay of each channel (iterative process)
+						pIter[4 * i + j] = MeanDelay_32f(resize.filtered(j, i), &pPrefix[2 * (_len + 1) * i], maxIdx[j][l], roi_width, left, pParams.md_tolerance, md_temp);
+						mean_delay(i, j) = (md_temp + (float)resize.ch_start_ind1[j]) / resize.ActualFactor;
+					}
+
+					// 4. Subtract mean delay of IRF to mean delay of each channel
+					for (int j = 0; j < N - 1; j++)
+					{
+						//if ((!std::isnan(intensity(i, j + 1))) && (intensity(i, j + 1) > INTENSITY_THRES))
+						//	lifetime(i, j) = pParams.samp_intv * (mean_delay(i, j + 1) - mean_delay(i, 0)) - pParams.delay_offset[j];
+						//else if (std::isnan(intensity(i, j + 1)))
+						//	lifetime(i, j) = NAN;
+						//else if (intensity(i, j + 1) <= INTENSITY_THRES)
+						//	lifetime(i, j) = 0.0f;
+
+						if ((intensity(i, j + 1) > INTENSITY_THRES))
+							lifetime(i, j) = pParams.samp_intv * (mean_delay(i, j + 1) - mean_delay(i, 0)) - pParams.delay_offset[j];
+						else
+							lifetime(i, j) = 0.0f; // NAN;
+					}
+				}
             }
         });
-		
     }
 
     void WidthIndex_32f(const Ipp32f* src, Ipp32f th, Ipp32s length, Ipp32s& maxIdx, Ipp32s& width)
@@ -412,51 +850,122 @@ public:
         width = right0 - left0 + 1;
     }
 
-    void MeanDelay_32f(const RESIZE& resize, int offset, int aline, Ipp32s maxIdx, Ipp32s width, Ipp32s left, Ipp32f &mean_delay)
+    void WidthIndex8_32f(const Ipp32f* src, int stride, Ipp32f th, Ipp32s length, Ipp32f* buf, Ipp32s* maxIdx, Ipp32s* width)
+    {
+        // WidthIndex_32f of 8 A-lines (src + l * stride) at once, buf: A-line interleaved scratch (8 * length)
+        if (flimHasAVX2())
+        {
+            WidthIndex8_32f_AVX2(src, stride, th, length, buf, maxIdx, width);
+            return;
+        }
+
+        for (int l = 0; l < 8; l++)
+            WidthIndex_32f(src + l * stride, th, length, maxIdx[l], width[l]);
+    }
+
+    FLIM_TARGET_AVX2 static void WidthIndex8_32f_AVX2(const Ipp32f* src, int stride, Ipp32f th, Ipp32s length, Ipp32f* buf, Ipp32s* maxIdx, Ipp32s* width)
     {
-        Ipp32f sum, weight_sum;
-        int start;
+        __m256i vlane = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(stride));
+        __m256 vmax = _mm256_set1_ps(-FLT_MAX);
+        __m256i vidx = _mm256_setzero_si256();
+
+        // Maximum (first occurrence) while interleaving
+        for (Ipp32s k = 0; k < length; k++)
+        {
+            __m256 v = _mm256_i32gather_ps(src + k, vlane, 4);
+            _mm256_store_ps(buf + 8 * k, v);
+
+            __m256 gt = _mm256_cmp_ps(v, vmax, _CMP_GT_OQ);
+            vmax = _mm256_blendv_ps(vmax, v, gt);
+            vidx = _mm256_blendv_epi8(vidx, _mm256_set1_epi32(k), _mm256_castps_si256(gt));
+        }
+
+        // Last crossing before the maximum & first crossing after the maximum
+        __m256 vth = _mm256_mul_ps(vmax, _mm256_set1_ps(th));
+        __m256i vleft = _mm256_setzero_si256(), vright = _mm256_setzero_si256(), vfound = _mm256_setzero_si256();
+        for (Ipp32s k = 0; k < length; k++)
+        {
+            __m256i vk = _mm256_set1_epi32(k);
+            __m256i below = _mm256_castps_si256(_mm256_cmp_ps(_mm256_load_ps(buf + 8 * k), vth, _CMP_LT_OQ));
+            __m256i after = _mm256_cmpgt_epi32(vk, vidx); // k > maxIdx
+            __m256i at = _mm256_cmpeq_epi32(vk, vidx);
+
+            vleft = _mm256_blendv_epi8(vleft, vk, _mm256_andnot_si256(after, below));
+            __m256i first = _mm256_andnot_si256(vfound, _mm256_and_si256(below, _mm256_or_si256(after, at)));
+            vright = _mm256_blendv_epi8(vright, vk, first);
+            vfound = _mm256_or_si256(vfound, first);
+        }
+
+        _mm256_storeu_si256((__m256i*)maxIdx, vidx);
+        _mm256_storeu_si256((__m256i*)width, _mm256_add_epi32(_mm256_sub_epi32(vright, vleft), _mm256_set1_epi32(1)));
+    }
+
+    int MeanDelay_32f(const Ipp32f* src, Ipp64f* prefix, Ipp32s maxIdx, Ipp32s width, Ipp32s left, Ipp32f tol, Ipp32f &mean_delay)
+    {
+        // Centroid iteration over a sliding window; each window sum is O(1) from the prefix sums.
+        // Returns the number of iterations (the window stops moving at a fixed point).
+        Ipp64f* sum0 = prefix; // sum of src[0..k)
+        Ipp64f* sum1 = prefix + _len + 1; // sum of m * src[m] for m in [0..k)
+
+        sum0[0] = 0; sum1[0] = 0;
+        for (int m = 0; m < _len; m++)
+        {
+            sum0[m + 1] = sum0[m] + src[m];
+            sum1[m + 1] = sum1[m] + (Ipp64f)m * src[m];
+        }
+
+        Ipp64f sum, weight_sum;
+        int start, start_prev = 0;
+        int iter = 0;
 
         mean_delay = (float)maxIdx;
 
-        for (int i = 0; i < 10; i++)
+        while (iter < MEAN_DELAY_MAX_ITER)
         {
             start = (int)round(mean_delay) - left;
+            if ((iter > 0) && (start == start_prev))
+                break;
 
-            if ((start < 0) || (start + width > resize.pulse_roi_length))
+            if ((start < 0) || (width <= 0) || (start + width > _len))
             {
                 mean_delay = 0;
                 break;
             }
 
-            const float* pulse = &resize.filt_src(offset + start, aline);
-            sum = 0; weight_sum = 0;
-
-            if (resize.pSeq)
-            {
-                ippsDotProd_32f(pulse, &resize.pSeq[start], width, &weight_sum);
-                ippsSum_32f(pulse, width, &sum, ippAlgHintFast);
-            }
+            sum = sum0[start + width] - sum0[start];
+            weight_sum = sum1[start + width] - sum1[start];
+            iter++;
 
-            if (sum)
-                mean_delay = weight_sum / sum;
-            else
+            if (sum == 0)
             {
                 mean_delay = 0;
                 break;
             }
 
-            if ((mean_delay > resize.pulse_roi_length) || (mean_delay < 0))
+            Ipp32f md_prev = mean_delay;
+            mean_delay = (Ipp32f)(weight_sum / sum);
+
+            if ((mean_delay > _len) || (mean_delay < 0))
             {
                 mean_delay = 0;
                 break;
             }
+
+            if ((tol > 0) && (fabsf(mean_delay - md_prev) <= tol))
+                break;
+
+            start_prev = start;
         }
+
+        return iter;
     }
 
 public:
-    int roiWidth[4];
-    int _ny;
+    int _ny, _len;
+    Ipp64f* pPrefix;
+    Ipp32f* pBatch;
+    Ipp32s* pIter;
+    int iter_hist[MEAN_DELAY_MAX_ITER + 1];
     FloatArray2 mean_delay;
     FloatArray2 lifetime;
 };
@@ -476,9 +985,11 @@ private: // Not to call copy constrcutor and copy assignment operator
 public:
     // Generate fluorescence intensity & lifetime
     void operator()(FloatArray2& intensity, FloatArray2& mean_delay, FloatArray2& lifetime, Uint16Array2& pulse);
+    void operator()(FlimFrameResult& result, Uint16Array2& pulse);
 
     // For FLIM parameters setting
     void setParameters(Configuration* pConfig);
+    void syncParameters(const FLImProcess& primary);
 
     // For masking
     void saveMaskData(QString maskpath = "flim_mask.dat");
@@ -492,6 +1003,13 @@ public:
     INTENSITY _intensity; // intensity objects
     LIFETIME _lifetime; // lifetime objects
 
+    // Copy of the latest result & of the pulse of its first A-line (kept only while FlimCalibDlg is open)
+    bool calib_copy;
+    FlimFrameResult calib;
+    FloatArray calib_pulse; // jitter-compensated pulse, or the up-sampled pulse with spline_view
+    FloatArray calib_mask; // artifact mask of the pulse samples
+    std::mutex calib_mtx; // the processing buffers are re-allocated by initialize(): the dialog reads this copy only
+
 public:
 	// Callbacks
 	callback<const char*> SendStatusMessage;
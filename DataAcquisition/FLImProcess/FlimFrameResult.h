@@ -0,0 +1,136 @@
+#ifndef FLIM_FRAME_RESULT_H
+#define FLIM_FRAME_RESULT_H
+
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+
+#include <ipps.h>
+
+#include <Common/array.h>
+
+
+#define FLIM_RESULT_ALIGN			16 // floats per plane alignment (one 64-byte cache line)
+
+
+// FLIm result of a single frame: structure-of-arrays planes of 'alines' samples each
+struct FlimFrameResult
+{
+public:
+    enum plane { INTENSITY = 0, MEAN_DELAY = 4, LIFETIME = 8, N_PLANES = 11 };
+
+    FlimFrameResult(int _alines = 0) : alines(0), pitch(0), data(nullptr)
+    {
+        reset();
+        if (_alines > 0) allocate(_alines);
+    }
+
+    ~FlimFrameResult()
+    {
+        if (data) { ippsFree(data); data = nullptr; }
+    }
+
+private: // Not to call copy constrcutor and copy assignment operator
+    FlimFrameResult(const FlimFrameResult&);
+    FlimFrameResult& operator=(const FlimFrameResult&);
+
+public:
+    void allocate(int _alines)
+    {
+        // Every plane starts on a cache line (ippsMalloc is 64-byte aligned)
+        alines = _alines;
+        pitch = (alines + FLIM_RESULT_ALIGN - 1) / FLIM_RESULT_ALIGN * FLIM_RESULT_ALIGN;
+
+        if (data) { ippsFree(data); data = nullptr; }
+        data = ippsMalloc_32f(N_PLANES * pitch);
+        memset(data, 0, sizeof(float) * N_PLANES * pitch);
+    }
+
+    void reset()
+    {
+        frame_index = 0;
+        timestamp = 0;
+        saturated = 0;
+    }
+
+    void copyFrom(const FlimFrameResult& src)
+    {
+        if (alines != src.alines) allocate(src.alines);
+        memcpy(data, src.data, sizeof(float) * N_PLANES * pitch);
+
+        frame_index = src.frame_index;
+        timestamp = src.timestamp;
+        saturated = src.saturated;
+    }
+
+    // Plane access (ch: 0 ~ 3 for intensity & mean delay, 0 ~ 2 for lifetime)
+    float* plane(int i) const { return data + i * pitch; }
+    float* intensity(int ch) const { return plane(INTENSITY + ch); }
+    float* mean_delay(int ch) const { return plane(MEAN_DELAY + ch); }
+    float* lifetime(int ch) const { return plane(LIFETIME + ch); }
+
+    // A-line x channel views (column stride is the plane pitch)
+    np::FloatArray2 intensityView() const { return view(INTENSITY, 4); }
+    np::FloatArray2 meanDelayView() const { return view(MEAN_DELAY, 4); }
+    np::FloatArray2 lifetimeView() const { return view(LIFETIME, 3); }
+
+private:
+    np::FloatArray2 view(int first, int n) const
+    {
+        np::FloatArray2 arr(plane(first), alines, n);
+        arr._stride[1] = pitch;
+        return arr;
+    }
+
+public:
+    // Frame metadata
+    int frame_index;
+    int64_t timestamp; // acquisition time from the acquisition start [usec]
+    int saturated; // number of saturated A-line channels
+
+    // Planes
+    int alines, pitch;
+    float* data;
+};
+
+
+// Raw pulse frame handed from the acquisition callback to a processing worker
+struct FlimPulseFrame
+{
+public:
+    FlimPulseFrame(int scans, int alines) : frame_index(0), timestamp(0), buffer(scans, alines), pulse(buffer.raw_ptr(), scans, alines) {}
+
+private: // Not to call copy constrcutor and copy assignment operator
+    FlimPulseFrame(const FlimPulseFrame&);
+    FlimPulseFrame& operator=(const FlimPulseFrame&);
+
+public:
+    // Frame metadata (set by the acquisition callback)
+    int frame_index; // dispatch sequence number (the results are reassembled in this order)
+    int64_t timestamp; // acquisition time from the acquisition start [usec]
+
+    np::Array<uint16_t, 2, np::frame_allocator> buffer; // page-aligned & pre-faulted
+    np::Uint16Array2 pulse; // view of the buffer
+};
+
+
+// Recorded image of a single frame: intensity (3) & lifetime (3) planes of size x size
+struct FlimImageFrame
+{
+public:
+    enum plane { INTENSITY = 0, LIFETIME = 3, N_PLANES = 6 };
+
+    FlimImageFrame(float* _data, int _size) : data(_data), size(_size) {}
+
+    // ch: 0 ~ 2 (emission channels)
+    float* intensity(int ch) const { return data + (INTENSITY + ch) * size * size; }
+    float* lifetime(int ch) const { return data + (LIFETIME + ch) * size * size; }
+
+    static int length(int _size) { return N_PLANES * _size * _size; }
+
+public:
+    float* data;
+    int size;
+};
+
+#endif // FLIM_FRAME_RESULT_H
@@ -0,0 +1,140 @@
+#include "DirectFile.h"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+
+#if defined(_WIN32)
+
+DirectFile::DirectFile() : handle(INVALID_HANDLE_VALUE), direct(false)
+{
+}
+
+DirectFile::~DirectFile()
+{
+	if (isOpen()) CloseHandle(handle);
+}
+
+bool DirectFile::open(const QString& path)
+{
+	std::wstring wpath = path.toStdWString();
+
+	direct = true;
+	handle = CreateFileW(wpath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		direct = false;
+		handle = CreateFileW(wpath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+			FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	}
+
+	return isOpen();
+}
+
+bool DirectFile::close(int64_t length)
+{
+	if (!isOpen()) return false;
+
+	FILE_END_OF_FILE_INFO eof;
+	eof.EndOfFile.QuadPart = length;
+	bool trimmed = SetFileInformationByHandle(handle, FileEndOfFileInfo, &eof, sizeof(eof)) != 0;
+
+	CloseHandle(handle);
+	handle = INVALID_HANDLE_VALUE;
+
+	return trimmed;
+}
+
+bool DirectFile::isOpen() const
+{
+	return handle != INVALID_HANDLE_VALUE;
+}
+
+bool DirectFile::write(const void* data, size_t size)
+{
+	const char* ptr = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		DWORD chunk = (DWORD)((size < (1u << 30)) ? size : (1u << 30)), written = 0;
+		if (!WriteFile(handle, ptr, chunk, &written, NULL) || (written == 0))
+			return false;
+		ptr += written;
+		size -= written;
+	}
+
+	return true;
+}
+
+#else
+
+DirectFile::DirectFile() : fd(-1), direct(false)
+{
+}
+
+DirectFile::~DirectFile()
+{
+	if (isOpen()) ::close(fd);
+}
+
+bool DirectFile::open(const QString& path)
+{
+	QByteArray name = path.toUtf8();
+
+	direct = true;
+	fd = ::open(name.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+	if ((fd < 0) && (errno == EINVAL)) // e.g. tmpfs
+	{
+		direct = false;
+		fd = ::open(name.constData(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+
+	return isOpen();
+}
+
+bool DirectFile::close(int64_t length)
+{
+	if (!isOpen()) return false;
+
+	bool trimmed = ftruncate(fd, (off_t)length) == 0;
+
+	::close(fd);
+	fd = -1;
+
+	return trimmed;
+}
+
+bool DirectFile::isOpen() const
+{
+	return fd >= 0;
+}
+
+bool DirectFile::write(const void* data, size_t size)
+{
+	const char* ptr = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		ssize_t written = ::write(fd, ptr, size);
+		if (written < 0)
+		{
+			if (errno == EINTR) continue;
+			return false;
+		}
+		if (written == 0)
+			return false;
+		ptr += written;
+		size -= (size_t)written;
+	}
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef DIRECT_FILE_H
+#define DIRECT_FILE_H
+
+#include <QString>
+#include <QByteArray>
+
+#include <cstdint>
+
+#define DIRECT_FILE_ALIGN			4096 // sector alignment of unbuffered writes (covers 512e & 4Kn drives)
+
+
+// Sequential writer bypassing the OS file cache (FILE_FLAG_NO_BUFFERING / O_DIRECT)
+// Every write must start on an aligned address and cover a multiple of DIRECT_FILE_ALIGN bytes.
+class DirectFile
+{
+public:
+	explicit DirectFile();
+	virtual ~DirectFile();
+
+private: // Not to call copy constrcutor and copy assignment operator
+	DirectFile(const DirectFile&);
+	DirectFile& operator=(const DirectFile&);
+
+public:
+	bool open(const QString& path);
+	bool close(int64_t length); // trims the padding of the last block to the given file length
+	bool isOpen() const;
+	bool isDirect() const { return direct; } // false if the file system refused unbuffered I/O
+
+	bool write(const void* data, size_t size);
+
+private:
+#if defined(_WIN32)
+	void* handle;
+#else
+	int fd;
+#endif
+	bool direct;
+};
+
+#endif // DIRECT_FILE_H
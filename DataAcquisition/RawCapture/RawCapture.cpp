@@ -0,0 +1,205 @@
+#include "RawCapture.h"
+
+#include <QDateTime>
+
+#include <chrono>
+#include <cstring>
+
+
+RawCapture::RawCapture() :
+	frames_written(0), frames_dropped(0), _open(false), scans(0), alines(0),
+	block_fill(0), file_length(0), failed(false)
+{
+}
+
+RawCapture::~RawCapture()
+{
+	close();
+}
+
+
+bool RawCapture::open(const QString& path, int _scans, int _alines, const QByteArray& config)
+{
+	close();
+
+	if (!file.open(path))
+	{
+		SendStatusMessage("[Raw Capture] Failed to open the capture file.", true);
+		return false;
+	}
+
+	// 1. Staging block of the unbuffered writes
+	if (!block)
+		block = np::frame_allocator::allocate(RAW_CAPTURE_BLOCK_SIZE);
+	block_fill = 0;
+	file_length = 0;
+	failed = false;
+
+	// 2. File header & configuration snapshot (written with the first block)
+	RawCaptureHeader header;
+	memset(&header, 0, sizeof(RawCaptureHeader));
+	header.magic = RAW_CAPTURE_MAGIC;
+	header.version = RAW_CAPTURE_VERSION;
+	header.config_size = (uint32_t)config.size();
+	header.header_size = (uint32_t)sizeof(RawCaptureHeader) + header.config_size;
+	header.scans = _scans;
+	header.alines = _alines;
+	header.start_time = QDateTime::currentMSecsSinceEpoch();
+
+	if (!append(&header, sizeof(RawCaptureHeader)) || !append(config.constData(), config.size()))
+	{
+		SendStatusMessage("[Raw Capture] Failed to write the capture header.", true);
+		file.close(0);
+		return false;
+	}
+
+	// 3. Frame queue & writing thread
+	scans = _scans;
+	alines = _alines;
+	queue.allocate_queue_object(RAW_CAPTURE_BUFFER_SIZE, scans, alines);
+	frames_written = 0;
+	frames_dropped = 0;
+
+	_thread = std::thread(&RawCapture::run, this);
+	_open = true;
+
+	char msg[256];
+	sprintf(msg, "[Raw Capture] Capturing %d x %d frames to %s (%s)", scans, alines, path.toUtf8().constData(),
+		file.isDirect() ? "unbuffered" : "buffered: no unbuffered I/O on this file system");
+	SendStatusMessage(msg, false);
+
+	return true;
+}
+
+void RawCapture::close()
+{
+	{
+		std::unique_lock<std::mutex> lock(mtx); // no frame is being queued after this
+		if (!_open.load())
+			return;
+		_open = false;
+	}
+
+	// Write the queued frames and finish the writing thread
+	queue.stop();
+	if (_thread.joinable())
+		_thread.join();
+
+	// Last (partial) block, then the padding is trimmed
+	if (!failed && !flush())
+		SendStatusMessage("[Raw Capture] Error occurred while writing the last block...", true);
+	file.close(file_length);
+
+	char msg[256];
+	sprintf(msg, "[Raw Capture] %d frames written (%.2f MB), %d dropped (queue high-water: %d / %d)", frames_written.load(),
+		(double)file_length / 1024.0 / 1024.0, frames_dropped.load(), queue.high_water, queue.capacity());
+	SendStatusMessage(msg, false);
+}
+
+bool RawCapture::push(int frame_index, int64_t timestamp, const uint16_t* frame)
+{
+	std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+	if (!lock.owns_lock() || !_open.load())
+		return false;
+
+	FlimPulseFrame* buffer = queue.get_buffer();
+	if (buffer == nullptr)
+	{
+		frames_dropped++;
+		return false;
+	}
+
+	memcpy(buffer->pulse.raw_ptr(), frame, sizeof(uint16_t) * scans * alines);
+	buffer->frame_index = frame_index;
+	buffer->timestamp = timestamp;
+	queue.push(buffer);
+
+	return true;
+}
+
+
+void RawCapture::run()
+{
+	size_t frameSize = sizeof(uint16_t) * scans * alines;
+
+	std::chrono::steady_clock::time_point tick_last = std::chrono::steady_clock::now();
+	int64_t length_last = file_length;
+
+	FlimPulseFrame* buffer;
+	while ((buffer = queue.pop()) != nullptr)
+	{
+		RawFrameHeader record;
+		record.frame_index = buffer->frame_index;
+		record.reserved = 0;
+		record.timestamp = buffer->timestamp;
+
+		if (!failed)
+		{
+			failed = !append(&record, sizeof(RawFrameHeader)) || !append(buffer->pulse.raw_ptr(), frameSize);
+			if (failed)
+				SendStatusMessage("[Raw Capture] Error occurred while writing... (the remaining frames are discarded)", true);
+		}
+		queue.return_buffer(buffer);
+
+		if (!failed)
+			frames_written++;
+		else
+			frames_dropped++;
+
+		// Write rate & backlog (updated every 5 sec)
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tick_last;
+		if (elapsed.count() > 5.0)
+		{
+			char msg[256];
+			sprintf(msg, "[Raw Capture] %.1f MB/s, backlog %d (max %d) of %d frames, %d dropped",
+				(double)(file_length - length_last) / 1024.0 / 1024.0 / elapsed.count(),
+				queue.queued(), queue.high_water, queue.capacity(), frames_dropped.load());
+			SendStatusMessage(msg, false);
+
+			tick_last = std::chrono::steady_clock::now();
+			length_last = file_length;
+		}
+	}
+}
+
+bool RawCapture::append(const void* data, size_t size)
+{
+	char* block_ptr = static_cast<char*>(block.get());
+	const char* ptr = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		size_t n = RAW_CAPTURE_BLOCK_SIZE - block_fill;
+		if (n > size) n = size;
+
+		memcpy(block_ptr + block_fill, ptr, n);
+		block_fill += n;
+		file_length += n;
+		ptr += n;
+		size -= n;
+
+		// Full block straight to the disk
+		if (block_fill == RAW_CAPTURE_BLOCK_SIZE)
+		{
+			if (!file.write(block_ptr, RAW_CAPTURE_BLOCK_SIZE))
+				return false;
+			block_fill = 0;
+		}
+	}
+
+	return true;
+}
+
+bool RawCapture::flush()
+{
+	if (block_fill == 0)
+		return true;
+
+	// Zero padding up to the sector size (trimmed on close)
+	size_t padded = (block_fill + DIRECT_FILE_ALIGN - 1) / DIRECT_FILE_ALIGN * DIRECT_FILE_ALIGN;
+	memset(static_cast<char*>(block.get()) + block_fill, 0, padded - block_fill);
+
+	bool ok = file.write(block.get(), padded);
+	block_fill = 0;
+
+	return ok;
+}
@@ -0,0 +1,97 @@
+#ifndef RAW_CAPTURE_H
+#define RAW_CAPTURE_H
+
+#include <Doulos/Configuration.h>
+
+#include <Common/SyncRing.h>
+#include <Common/callback.h>
+
+#include <DataAcquisition/FLImProcess/FlimFrameResult.h>
+#include <DataAcquisition/RawCapture/DirectFile.h>
+
+#include <QString>
+#include <QByteArray>
+
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+#define RAW_CAPTURE_MAGIC			0x57415244 // "DRAW"
+#define RAW_CAPTURE_VERSION			1
+
+
+// File header of a raw capture (followed by the configuration snapshot, then by the frame records)
+struct RawCaptureHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t header_size; // bytes before the first frame record
+	uint32_t config_size; // bytes of the configuration snapshot (Doulos.ini text)
+	int32_t scans; // samples per A-line (all digitizer channels)
+	int32_t alines; // A-lines per frame
+	int64_t start_time; // capture start [msec since epoch]
+};
+
+// Frame record header (followed by scans x alines uint16 samples)
+struct RawFrameHeader
+{
+	int32_t frame_index; // DAQ frame index
+	int32_t reserved;
+	int64_t timestamp; // acquisition time from the acquisition start [usec]
+};
+
+static_assert(sizeof(RawCaptureHeader) == 32, "RawCaptureHeader must be packed to 32 bytes.");
+static_assert(sizeof(RawFrameHeader) == 16, "RawFrameHeader must be packed to 16 bytes.");
+
+
+// Streaming writer of the raw digitizer frames (frames are queued by the DAQ callback and written by its own thread)
+// Records are gathered into an aligned block and written with unbuffered I/O, RAW_CAPTURE_BLOCK_SIZE bytes at a time.
+class RawCapture
+{
+public:
+	explicit RawCapture();
+	virtual ~RawCapture();
+
+private: // Not to call copy constrcutor and copy assignment operator
+	RawCapture(const RawCapture&);
+	RawCapture& operator=(const RawCapture&);
+
+public:
+	bool open(const QString& path, int scans, int alines, const QByteArray& config);
+	void close();
+	bool isOpen() const { return _open.load(); }
+
+	// Queue a frame (DAQ thread, never blocks: false if the writer is behind)
+	bool push(int frame_index, int64_t timestamp, const uint16_t* frame);
+
+public:
+	callback2<const char*, bool> SendStatusMessage;
+
+	std::atomic<int> frames_written;
+	std::atomic<int> frames_dropped;
+
+private:
+	void run();
+	std::thread _thread;
+
+	std::atomic<bool> _open;
+	std::mutex mtx;
+
+	SyncRing<FlimPulseFrame> queue;
+	int scans, alines;
+
+private:
+	// Unbuffered file & its staging block
+	DirectFile file;
+	std::shared_ptr<void> block;
+	size_t block_fill;
+	int64_t file_length;
+	bool failed;
+
+	bool append(const void* data, size_t size);
+	bool flush();
+};
+
+#endif // RAW_CAPTURE_H
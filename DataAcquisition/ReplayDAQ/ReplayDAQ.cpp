@@ -0,0 +1,193 @@
+#include "ReplayDAQ.h"
+
+#include <QDateTime>
+
+#include <chrono>
+#include <cstring>
+
+using namespace std;
+
+
+ReplayDAQ::ReplayDAQ() :
+	Speed(1.0f), Loop(false),
+	_dirty(true), nFrames(0)
+{
+	memset(&header, 0, sizeof(RawCaptureHeader));
+}
+
+ReplayDAQ::~ReplayDAQ()
+{
+	if (_thread.joinable())
+	{
+		_running = false;
+		_thread.join();
+	}
+	if (file.isOpen()) file.close();
+}
+
+
+bool ReplayDAQ::initialize()
+{
+	char msg[MAX_MSG_LENGTH];
+	sprintf(msg, "Initializing replay of %s...", FilePath.toUtf8().constData());
+	SendStatusMessage(msg, false);
+
+	// Capture file & header
+	file.setFileName(FilePath);
+	if (!file.open(QIODevice::ReadOnly))
+	{
+		SendStatusMessage("ERROR: Failed to open the raw capture file.", true);
+		return false;
+	}
+
+	if ((file.read(reinterpret_cast<char*>(&header), sizeof(RawCaptureHeader)) != sizeof(RawCaptureHeader))
+		|| (header.magic != RAW_CAPTURE_MAGIC) || (header.version != RAW_CAPTURE_VERSION))
+	{
+		SendStatusMessage("ERROR: Not a raw capture file (or an unsupported version).", true);
+		file.close();
+		return false;
+	}
+
+	if ((header.scans != nChannels * nScans) || (header.alines != nAlines))
+	{
+		sprintf(msg, "ERROR: Frame size of the raw capture (%d x %d) does not match the configuration (%d x %d).",
+			header.scans, header.alines, nChannels * nScans, nAlines);
+		SendStatusMessage(msg, true);
+		file.close();
+		return false;
+	}
+
+	qint64 recordSize = sizeof(RawFrameHeader) + sizeof(uint16_t) * (qint64)header.scans * header.alines;
+	nFrames = (int)((file.size() - header.header_size) / recordSize);
+
+	// Double buffer
+	ring = np::Array<uint16_t, 2, np::frame_allocator>(header.scans, 2 * header.alines);
+
+	sprintf(msg, "Replay is successfully initialized. [%d frames captured at %s, %s]", nFrames,
+		QDateTime::fromMSecsSinceEpoch(header.start_time).toString("yyyy-MM-dd hh:mm:ss").toUtf8().constData(),
+		(Speed > 0) ? QString("x%1 speed").arg(Speed, 0, 'f', 2).toUtf8().constData() : "as fast as possible");
+	SendStatusMessage(msg, false);
+
+	return true;
+}
+
+bool ReplayDAQ::set_init()
+{
+	if (_dirty)
+	{
+		if (!initialize())
+			return false;
+
+		_dirty = false;
+	}
+
+	return true;
+}
+
+bool ReplayDAQ::startAcquisition()
+{
+	if (_thread.joinable())
+	{
+		SendStatusMessage("ERROR: Acquisition is already running.", true);
+		return false;
+	}
+
+	_thread = std::thread(&ReplayDAQ::run, this); // thread executing
+
+	SendStatusMessage("Data acquisition thread is started. (replay)", false);
+
+	return true;
+}
+
+void ReplayDAQ::stopAcquisition()
+{
+	if (_thread.joinable())
+	{
+		DidStopData();
+		_thread.join();
+	}
+
+	SendStatusMessage("Data acquisition thread is finished normally.", false);
+}
+
+
+// Acquisition Thread
+void ReplayDAQ::run()
+{
+	unsigned int frameIndex = 0;
+	int64_t first_timestamp = -1;
+
+	std::chrono::steady_clock::time_point tick_start = std::chrono::steady_clock::now(), tick_last_update = tick_start;
+	unsigned long long SamplesAcquired = 0, SamplesAcquiredUpdate = 0;
+
+	// Every acquisition replays from the first frame
+	file.seek(header.header_size);
+
+	_running = true;
+	while (_running)
+	{
+		// Read the next frame into the free half of the double buffer
+		uint16_t* cur_framep = ring.raw_ptr() + (frameIndex % 2) * header.scans * header.alines;
+		RawFrameHeader record;
+		if (!readFrame(cur_framep, record))
+		{
+			if (Loop && (nFrames > 0))
+			{
+				file.seek(header.header_size);
+				first_timestamp = -1;
+				continue;
+			}
+
+			SendStatusMessage("Replay reached the end of the raw capture.", false);
+			while (_running)
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			break;
+		}
+
+		// Recorded timing
+		if (Speed > 0)
+		{
+			if (first_timestamp < 0)
+			{
+				first_timestamp = record.timestamp;
+				tick_start = std::chrono::steady_clock::now();
+			}
+			std::this_thread::sleep_until(tick_start + std::chrono::microseconds((long long)((double)(record.timestamp - first_timestamp) / Speed)));
+		}
+
+		// Callback
+		np::Uint16Array2 frame(cur_framep, header.scans, header.alines);
+		DidAcquireData(frameIndex++, frame); // Callback function
+
+		// Update counters
+		SamplesAcquired += (unsigned long long)header.scans * header.alines;
+		SamplesAcquiredUpdate += (unsigned long long)header.scans * header.alines;
+
+		// Periodically update progress
+		std::chrono::steady_clock::time_point tick_now = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed_update = tick_now - tick_last_update;
+		if (elapsed_update.count() > 5.0)
+		{
+			tick_last_update = tick_now;
+
+			char msg[MAX_MSG_LENGTH];
+			sprintf(msg, "[Replay] frame %u [DAQ Rate] %3.2f MS/s", frameIndex, (SamplesAcquiredUpdate / 1000000.0) / elapsed_update.count());
+			SendStatusMessage(msg, false);
+
+			// reset
+			SamplesAcquiredUpdate = 0;
+		}
+	}
+}
+
+bool ReplayDAQ::readFrame(uint16_t* dst, RawFrameHeader& record)
+{
+	qint64 frameSize = sizeof(uint16_t) * (qint64)header.scans * header.alines;
+
+	if (file.read(reinterpret_cast<char*>(&record), sizeof(RawFrameHeader)) != sizeof(RawFrameHeader))
+		return false;
+	if (file.read(reinterpret_cast<char*>(dst), frameSize) != frameSize)
+		return false;
+
+	return true;
+}
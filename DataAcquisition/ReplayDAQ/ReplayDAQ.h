@@ -0,0 +1,53 @@
+#ifndef REPLAY_DAQ_H
+#define REPLAY_DAQ_H
+
+#include <Doulos/Configuration.h>
+
+#include <DataAcquisition/DaqInterface.h>
+#include <DataAcquisition/RawCapture/RawCapture.h>
+
+#include <QString>
+#include <QFile>
+
+#include <iostream>
+#include <thread>
+
+
+// Replay of a raw capture: recorded frames delivered through DidAcquireData at the original timing or as fast as possible
+class ReplayDAQ : public DaqInterface
+{
+public:
+	explicit ReplayDAQ();
+	virtual ~ReplayDAQ();
+
+public:
+	bool initialize();
+	bool set_init();
+
+	bool startAcquisition();
+	void stopAcquisition();
+
+public:
+	QString FilePath; // raw capture file
+	float Speed; // playback speed relative to the recorded timing (0: as fast as possible)
+	bool Loop; // restart from the first frame at the end of the capture
+
+private:
+	bool _dirty;
+
+	// thread
+	std::thread _thread;
+	void run();
+
+private:
+	QFile file;
+	RawCaptureHeader header;
+	int nFrames;
+
+	// Double buffer of frames (the previous frame stays valid during the callback of the current one)
+	np::Array<uint16_t, 2, np::frame_allocator> ring;
+
+	bool readFrame(uint16_t* dst, RawFrameHeader& record);
+};
+
+#endif // REPLAY_DAQ_H
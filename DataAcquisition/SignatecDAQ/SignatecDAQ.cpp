@@ -7,11 +7,10 @@ using namespace std;
 
 
 SignatecDAQ::SignatecDAQ() :
-    nChannels(1), nScans(512), nAlines(1024),
     VoltRange1(PX14VOLTRNG_3_487_VPP), VoltRange2(PX14VOLTRNG_1_557_VPP), AcqRate(PX14_ADC_RATE),
     PreTrigger(0), TriggerDelay(0), BootTimeBufIdx(0),
     UseVirtualDevice(false), UseInternalTrigger(false),
-    _dirty(true), _running(false), _board(PX14_INVALID_HANDLE),
+    _dirty(true), _board(PX14_INVALID_HANDLE),
     dma_bufp(nullptr)
 {
 }
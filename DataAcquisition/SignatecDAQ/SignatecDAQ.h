@@ -3,27 +3,19 @@
 
 #include <Doulos/Configuration.h>
 
-#include <Common/array.h>
-#include <Common/callback.h>
+#include <DataAcquisition/DaqInterface.h>
 
 #include <iostream>
 #include <thread>
 
-#define MAX_MSG_LENGTH 2000
-
 
 typedef struct _px14hs_* HPX14;
 
-class SignatecDAQ
+class SignatecDAQ : public DaqInterface
 {
 public:
 	explicit SignatecDAQ();
 	virtual ~SignatecDAQ();
-
-	// callbacks
-	callback2<int, const np::Uint16Array2 &> DidAcquireData; 
-    callback<void> DidStopData;
-	callback2<const char*, bool> SendStatusMessage;
 	
 public:
 	bool initialize();
@@ -35,15 +27,12 @@ public:
 	void stopAcquisition();
 
 public:
-    int nChannels, nScans, nAlines;
     int VoltRange1, VoltRange2;
     unsigned int AcqRate;
     unsigned int PreTrigger, TriggerDelay;
     unsigned short BootTimeBufIdx;
     bool UseVirtualDevice, UseInternalTrigger;
 
-	bool _running;
-
 private:
     bool _dirty;
 
@@ -0,0 +1,264 @@
+#include "SimulatorDAQ.h"
+
+#include <chrono>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+
+
+SimulatorDAQ::SimulatorDAQ() :
+	Bg(33000.0f), SampIntv(1000.0f / (float)PX14_ADC_RATE), nCh(4),
+	Jitter(0.5f), Noise(30.0f), Saturation(0.01f), DaqRate(0.0),
+	_dirty(true)
+{
+	const int ch_start_ind[4] = { 30, 69, 98, 132 };
+	const float delay_offset[3] = { 96.0f, 166.0f, 253.0f };
+	const float amplitude[4] = { 20000.0f, 8000.0f, 12000.0f, 4000.0f };
+	const float lifetime[3] = { 2.5f, 4.0f, 1.5f };
+
+	memcpy(ChStartInd, ch_start_ind, sizeof(ChStartInd));
+	memcpy(DelayOffset, delay_offset, sizeof(DelayOffset));
+	memcpy(Amplitude, amplitude, sizeof(Amplitude));
+	memcpy(Lifetime, lifetime, sizeof(Lifetime));
+}
+
+SimulatorDAQ::~SimulatorDAQ()
+{
+	if (_thread.joinable())
+	{
+		_running = false;
+		_thread.join();
+	}
+}
+
+
+bool SimulatorDAQ::initialize()
+{
+	SendStatusMessage("Initializing FLIm DAQ simulator...", false);
+
+	if ((nScans <= 0) || (nAlines % 4) || (nChannels <= 0))
+	{
+		SendStatusMessage("ERROR: Invalid frame size for the DAQ simulator.", true);
+		return false;
+	}
+
+	// 1. Pulse templates: amplitude levels (the last one saturated) x sub-sample trigger phases
+	templates.resize((size_t)(SIM_PULSE_LEVELS + 1) * SIM_PULSE_PHASES * nScans);
+	for (int l = 0; l <= SIM_PULSE_LEVELS; l++)
+	{
+		float scale = (l < SIM_PULSE_LEVELS) ? (float)(l + 1) / (float)SIM_PULSE_LEVELS : 3.0f;
+		for (int p = 0; p < SIM_PULSE_PHASES; p++)
+		{
+			float shift = Jitter * ((float)p / (float)(SIM_PULSE_PHASES - 1) - 0.5f);
+			makeTemplate(&templates[((size_t)l * SIM_PULSE_PHASES + p) * nScans], scale, shift);
+		}
+	}
+
+	// 2. Noise table
+	noise.resize(SIM_NOISE_LENGTH);
+	std::mt19937 engine(2018);
+	std::normal_distribution<float> gauss(0.0f, Noise);
+	for (int i = 0; i < SIM_NOISE_LENGTH; i++)
+		noise[i] = (int16_t)std::max(-32768.0f, std::min(32767.0f, roundf(gauss(engine))));
+
+	// 3. DMA-style ring (8 quarter-frame chunks)
+	ring = np::Array<uint16_t, 2, np::frame_allocator>(nChannels * nScans, 2 * nAlines);
+
+	char msg[MAX_MSG_LENGTH];
+	sprintf(msg, "FLIm DAQ simulator is successfully initialized. [%d x %d, %.2f MS/s%s]",
+		nScans, nAlines, DaqRate, (DaqRate > 0) ? "" : " (free-running)");
+	SendStatusMessage(msg, false);
+
+	return true;
+}
+
+bool SimulatorDAQ::set_init()
+{
+	if (_dirty)
+	{
+		if (!initialize())
+			return false;
+
+		_dirty = false;
+	}
+
+	return true;
+}
+
+bool SimulatorDAQ::startAcquisition()
+{
+	if (_thread.joinable())
+	{
+		SendStatusMessage("ERROR: Acquisition is already running.", true);
+		return false;
+	}
+
+	_thread = std::thread(&SimulatorDAQ::run, this); // thread executing
+
+	SendStatusMessage("Data acquisition thread is started. (simulator)", false);
+
+	return true;
+}
+
+void SimulatorDAQ::stopAcquisition()
+{
+	if (_thread.joinable())
+	{
+		DidStopData();
+		_thread.join();
+	}
+
+	SendStatusMessage("Data acquisition thread is finished normally.", false);
+}
+
+
+// Acquisition Thread
+void SimulatorDAQ::run()
+{
+	unsigned loop_counter = 0; // uint32
+	uint16_t *cur_chunkp = nullptr;
+	uint16_t *prev_chunkp = nullptr;
+
+	unsigned long long SamplesAcquired = 0, SamplesAcquiredUpdate = 0;
+
+	unsigned int frameIndex = 0;
+	unsigned int seed = 0x2545F491;
+
+	// Chunk period at the target sample rate
+	std::chrono::steady_clock::time_point tick_start = std::chrono::steady_clock::now(), tick_last_update = tick_start, tick_next = tick_start;
+	std::chrono::nanoseconds chunk_period((DaqRate > 0) ? (long long)((double)getDataBufferSize() / DaqRate * 1000.0) : 0);
+
+	_running = true;
+	while (_running)
+	{
+		// Generate the next chunk where the DMA transfer would write it
+		cur_chunkp = ring.raw_ptr() + ((loop_counter % 8) * getDataBufferSize());
+		fillChunk(cur_chunkp, (loop_counter % 4) * (nAlines / 4), nAlines / 4, frameIndex, seed);
+
+		// Wait for the chunk period (a pipeline behind by more than the ring restarts the clock, as an overflowed FIFO)
+		if (DaqRate > 0)
+		{
+			tick_next += chunk_period;
+			std::chrono::steady_clock::time_point tick_now = std::chrono::steady_clock::now();
+			if (tick_now > tick_next + 8 * chunk_period)
+				tick_next = tick_now;
+			std::this_thread::sleep_until(tick_next);
+		}
+
+		// Update counters
+		SamplesAcquired += getDataBufferSize();
+		SamplesAcquiredUpdate += getDataBufferSize();
+		loop_counter++;
+
+		// Callback with the completed half of the ring
+		if (loop_counter % 4 == 0)
+		{
+			if (loop_counter % 8 == 0)
+				prev_chunkp = ring.raw_ptr() + 4 * getDataBufferSize(); // last half of buffer
+			else
+				prev_chunkp = ring.raw_ptr(); // first half of buffer
+
+			np::Uint16Array2 frame(prev_chunkp, nChannels * nScans, nAlines);
+			DidAcquireData(frameIndex++, frame); // Callback function
+		}
+
+		// Periodically update progress
+		std::chrono::steady_clock::time_point tick_now = std::chrono::steady_clock::now();
+		std::chrono::duration<double> elapsed_update = tick_now - tick_last_update;
+		if (elapsed_update.count() > 5.0)
+		{
+			std::chrono::duration<double> elapsed = tick_now - tick_start;
+			tick_last_update = tick_now;
+
+			double dRateUpdate = (SamplesAcquiredUpdate / 1000000.0) / elapsed_update.count();
+
+			unsigned s = (unsigned)elapsed.count();
+			unsigned h = s / 3600, m = (s / 60) % 60;
+			s %= 60;
+
+			char msg[MAX_MSG_LENGTH];
+			sprintf(msg, "[Elapsed Time] %u:%02u:%02u [DAQ Rate] %3.2f MS/s [Frame Rate] %.2f fps (simulator)", h, m, s, dRateUpdate, (double)frameIndex / elapsed.count());
+			SendStatusMessage(msg, false);
+
+			// reset
+			SamplesAcquiredUpdate = 0;
+		}
+	}
+}
+
+
+void SimulatorDAQ::makeTemplate(uint16_t* dst, float scale, float shift)
+{
+	// IRF: gaussian, emission: the gaussian convolved with a single exponential decay (peak-normalized)
+	const float pi = 3.14159265f;
+	const float sigma = SIM_IRF_SIGMA;
+	const float mu0 = (float)ChStartInd[0] + SIM_IRF_DELAY;
+
+	std::vector<float> pulse(nScans, Bg);
+	std::vector<float> shape(nScans);
+	for (int c = 0; c < nCh; c++)
+	{
+		float mu = (c == 0) ? mu0 : mu0 + DelayOffset[c - 1] / SampIntv;
+		float tau = (c == 0) ? 0.0f : Lifetime[c - 1] / SampIntv;
+
+		float peak = 0.0f;
+		for (int i = 0; i < nScans; i++)
+		{
+			float u = ((float)i - shift - mu) / sigma;
+			if (tau <= 0.0f)
+				shape[i] = expf(-0.5f * u * u);
+			else
+			{
+				// exp(z^2) erfc(z) in a form that neither overflows nor cancels
+				float z = (sigma / tau - u) / sqrtf(2.0f);
+				if (z < 5.0f)
+					shape[i] = 0.5f * expf(z * z - 0.5f * u * u) * erfcf(z);
+				else
+					shape[i] = 0.5f * expf(-0.5f * u * u) / (z * sqrtf(pi));
+			}
+			peak = std::max(peak, shape[i]);
+		}
+
+		if (peak > 0.0f)
+			for (int i = 0; i < nScans; i++)
+				pulse[i] += scale * Amplitude[c] * shape[i] / peak;
+	}
+
+	for (int i = 0; i < nScans; i++)
+		dst[i] = (uint16_t)std::max(0.0f, std::min(65535.0f, roundf(pulse[i])));
+}
+
+void SimulatorDAQ::fillChunk(uint16_t* dst, int aline_start, int n_alines, unsigned int frameIndex, unsigned int& seed)
+{
+	const float pi = 3.14159265f;
+	for (int j = 0; j < n_alines; j++)
+	{
+		// Amplitude: slowly drifting stripes across the frame, some A-lines saturated
+		int aline = aline_start + j;
+		float pattern = 0.5f + 0.5f * sinf(8.0f * pi * (float)aline / (float)nAlines + 0.05f * (float)frameIndex);
+		int level = std::min(SIM_PULSE_LEVELS - 1, (int)(pattern * SIM_PULSE_LEVELS));
+
+		// xorshift32
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		if ((float)seed / 4294967296.0f < Saturation)
+			level = SIM_PULSE_LEVELS;
+		seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+		int phase = seed % SIM_PULSE_PHASES;
+		int offset = (seed >> 3) % (SIM_NOISE_LENGTH - nScans);
+
+		const uint16_t* tmpl = &templates[((size_t)level * SIM_PULSE_PHASES + phase) * nScans];
+		const int16_t* n = &noise[offset];
+		for (int c = 0; c < nChannels; c++)
+		{
+			uint16_t* aline_ptr = dst + (size_t)j * nChannels * nScans + c * nScans;
+			for (int i = 0; i < nScans; i++)
+			{
+				int v = (int)tmpl[i] + (int)n[i];
+				aline_ptr[i] = (uint16_t)((v < 0) ? 0 : ((v > 65535) ? 65535 : v));
+			}
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#ifndef SIMULATOR_DAQ_H
+#define SIMULATOR_DAQ_H
+
+#include <Doulos/Configuration.h>
+
+#include <DataAcquisition/DaqInterface.h>
+
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#define SIM_PULSE_LEVELS			16 // amplitude levels of the pulse templates
+#define SIM_PULSE_PHASES			8 // sub-sample trigger phases of the pulse templates
+#define SIM_NOISE_LENGTH			65536 // samples of the pre-generated noise table
+#define SIM_IRF_SIGMA				1.0f // instrument response width [samples]
+#define SIM_IRF_DELAY				6.0f // IRF peak after the channel 0 window start [samples]
+
+
+// Software digitizer: synthetic FLIm pulses delivered through the 8-chunk ring of SignatecDAQ at a target sample rate
+class SimulatorDAQ : public DaqInterface
+{
+public:
+	explicit SimulatorDAQ();
+	virtual ~SimulatorDAQ();
+
+public:
+	bool initialize();
+	bool set_init();
+
+	bool startAcquisition();
+	void stopAcquisition();
+
+public:
+	// Pulse model
+	float Bg; // baseline [ADC counts]
+	float SampIntv; // sampling interval [nsec]
+	int nCh; // IRF + emission channels (4 or 2)
+	int ChStartInd[4]; // channel window starts [samples]
+	float DelayOffset[3]; // emission channel delays from the IRF [nsec]
+	float Amplitude[4]; // pulse peaks above the baseline [ADC counts]
+	float Lifetime[3]; // emission lifetimes [nsec]
+
+	// Impairments
+	float Jitter; // trigger jitter (peak-to-peak) [samples]
+	float Noise; // additive gaussian noise (rms) [ADC counts]
+	float Saturation; // ratio of A-lines driven beyond the ADC range
+
+	// Timing
+	double DaqRate; // target sample rate [MS/s] (0: as fast as possible)
+
+private:
+	bool _dirty;
+
+	// thread
+	std::thread _thread;
+	void run();
+
+private:
+	// Pulse templates (level x phase, nScans samples each) & noise table
+	std::vector<uint16_t> templates;
+	std::vector<int16_t> noise;
+
+	// DMA-style ring of 8 chunks (two frames)
+	np::Array<uint16_t, 2, np::frame_allocator> ring;
+
+	// Data buffer size (quarter frame, as the PX14400 chunk)
+	int getDataBufferSize() { return nChannels * nScans * nAlines / 4; }
+
+	void makeTemplate(uint16_t* dst, float amplitude, float shift);
+	void fillChunk(uint16_t* dst, int aline_start, int n_alines, unsigned int frameIndex, unsigned int& seed);
+};
+
+#endif // SIMULATOR_DAQ_H
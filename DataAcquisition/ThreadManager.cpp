@@ -1,5 +1,6 @@
 
 #include "ThreadManager.h"
+#include <cstring>
 
 
 ThreadManager::ThreadManager(const char* _threadID) :
@@ -55,14 +55,23 @@ SOURCES += Doulos/Doulos.cpp \
     Doulos/QVisualizationTab.cpp \
     Doulos/Viewer/QScope.cpp \
     Doulos/Viewer/QImageView.cpp \
+    Doulos/Viewer/ColorTable.cpp \
     Doulos/Dialog/FlimCalibDlg.cpp
 
+SOURCES += Common/allocator.cpp
+
 SOURCES += DataAcquisition/SignatecDAQ/SignatecDAQ.cpp \
+    DataAcquisition/SimulatorDAQ/SimulatorDAQ.cpp \
+    DataAcquisition/ReplayDAQ/ReplayDAQ.cpp \
+    DataAcquisition/RawCapture/RawCapture.cpp \
+    DataAcquisition/RawCapture/DirectFile.cpp \
     DataAcquisition/FLImProcess/FLImProcess.cpp \
     DataAcquisition/ThreadManager.cpp \
     DataAcquisition/DataAcquisition.cpp
 
-SOURCES += MemoryBuffer/MemoryBuffer.cpp
+SOURCES += MemoryBuffer/MemoryBuffer.cpp \
+    MemoryBuffer/FlimContainer.cpp \
+    MemoryBuffer/FlimSession.cpp
 
 SOURCES += DeviceControl/FLImControl/PmtGainControl.cpp \
     DeviceControl/FLImControl/FLImTrigger.cpp \
@@ -80,14 +89,26 @@ HEADERS += Doulos/Configuration.h \
     Doulos/QVisualizationTab.h \
     Doulos/Viewer/QScope.h \
     Doulos/Viewer/QImageView.h \
+    Doulos/Viewer/ColorTable.h \
     Doulos/Dialog/FlimCalibDlg.h
 
-HEADERS += DataAcquisition/SignatecDAQ/SignatecDAQ.h \
+HEADERS += Common/allocator.h \
+    Common/SyncRing.h
+
+HEADERS += DataAcquisition/DaqInterface.h \
+    DataAcquisition/SignatecDAQ/SignatecDAQ.h \
+    DataAcquisition/SimulatorDAQ/SimulatorDAQ.h \
+    DataAcquisition/ReplayDAQ/ReplayDAQ.h \
+    DataAcquisition/RawCapture/RawCapture.h \
+    DataAcquisition/RawCapture/DirectFile.h \
     DataAcquisition/FLImProcess/FLImProcess.h \
+    DataAcquisition/FLImProcess/FlimFrameResult.h \
     DataAcquisition/ThreadManager.h \
     DataAcquisition/DataAcquisition.h
 
-HEADERS += MemoryBuffer/MemoryBuffer.h
+HEADERS += MemoryBuffer/MemoryBuffer.h \
+    MemoryBuffer/FlimContainer.h \
+    MemoryBuffer/FlimSession.h
 
 HEADERS += DeviceControl/FLImControl/PmtGainControl.h \
     DeviceControl/FLImControl/FLImTrigger.h \
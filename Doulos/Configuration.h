@@ -15,6 +15,10 @@
 
 #define PX14_BOOTBUF_IDX            3
 
+#define DAQ_BACKEND_PX14400			0
+#define DAQ_BACKEND_SIMULATOR		1
+#define DAQ_BACKEND_REPLAY			2
+
 #define FLIM_SCANS                  512
 #define FLIM_ALINES                 1024
 
@@ -35,7 +39,12 @@
 
 
 //////////////// Thread & Buffer Processing /////////////////
-#define PROCESSING_BUFFER_SIZE		100
+#define PROCESSING_BUFFER_SIZE		100 // split among the processing workers
+#define FLIM_PROCESSING_WORKERS		2 // frame-level FLIm processing threads (each with its own FLImProcess; frames dealt in turn, passed to the next worker when one is full)
+#define RAW_CAPTURE_BUFFER_SIZE		50 // frames queued for the raw capture writer
+#define RAW_CAPTURE_BLOCK_SIZE		(8 * 1024 * 1024) // bytes per unbuffered disk write
+#define WRITING_BUFFER_SIZE			4 // recycled image buffers between recording and the spool file
+#define WRITING_BUFFER_TIMEOUT		1000 // msec
 
 
 ///////////////////// FLIm Processing ///////////////////////
@@ -43,6 +52,7 @@
 #define GAUSSIAN_FILTER_WIDTH		200
 #define GAUSSIAN_FILTER_STD			48
 #define FLIM_SPLINE_FACTOR			20
+#define FLIM_SPLINE_BAND			16
 #define INTENSITY_THRES				0.05f
 
 /////////////////////// Visualization ///////////////////////
@@ -101,9 +111,32 @@ public:
 		imageStichingYStep = settings.value("imageStichingYStep").toInt();
 		imageStichingMisSyncPos = settings.value("imageStichingMisSyncPos").toInt();
 
+		// Back-pressure of the acquisition pipeline
+		flimBackPressure = settings.value("flimBackPressure").toInt();
+		flimDecimation = settings.value("flimDecimation").toInt();
+		if (flimDecimation < 2) flimDecimation = 2;
+
+		// Acquisition backend (DAQ simulator settings)
+		daqBackend = settings.value("daqBackend").toInt();
+		simDaqRate = settings.value("simDaqRate").toFloat();
+		for (int i = 0; i < 3; i++)
+			simLifetime[i] = settings.value(QString("simLifetime_%1").arg(i + 1)).toFloat();
+		simJitter = settings.value("simJitter").toFloat();
+		simNoise = settings.value("simNoise").toFloat();
+		simSaturation = settings.value("simSaturation").toFloat();
+
+		// Raw capture replay
+		replayPath = settings.value("replayPath").toString();
+		replaySpeed = settings.value("replaySpeed").toFloat();
+		replayLoop = settings.value("replayLoop").toBool();
+
         // FLIm processing
 		flimBg = settings.value("flimBg").toFloat();
 		flimWidthFactor = settings.value("flimWidthFactor").toFloat();
+		flimChannels = settings.value("flimChannels").toInt();
+		if (flimChannels != 2) flimChannels = 4;
+		flimUpsampleMode = settings.value("flimUpsampleMode").toInt();
+		flimMeanDelayTolerance = settings.value("flimMeanDelayTolerance").toFloat();
 		for (int i = 0; i < 4; i++)
 		{
 			flimChStartInd[i] = settings.value(QString("flimChStartInd_%1").arg(i)).toInt();
@@ -155,9 +188,30 @@ public:
 		settings.setValue("imageStichingYStep", imageStichingYStep);
 		settings.setValue("imageStichingMisSyncPos", imageStichingMisSyncPos);
 
+		// Back-pressure of the acquisition pipeline
+		settings.setValue("flimBackPressure", flimBackPressure);
+		settings.setValue("flimDecimation", flimDecimation);
+
+		// Acquisition backend (DAQ simulator settings)
+		settings.setValue("daqBackend", daqBackend);
+		settings.setValue("simDaqRate", QString::number(simDaqRate, 'f', 2));
+		for (int i = 0; i < 3; i++)
+			settings.setValue(QString("simLifetime_%1").arg(i + 1), QString::number(simLifetime[i], 'f', 2));
+		settings.setValue("simJitter", QString::number(simJitter, 'f', 2));
+		settings.setValue("simNoise", QString::number(simNoise, 'f', 1));
+		settings.setValue("simSaturation", QString::number(simSaturation, 'f', 3));
+
+		// Raw capture replay
+		settings.setValue("replayPath", replayPath);
+		settings.setValue("replaySpeed", QString::number(replaySpeed, 'f', 2));
+		settings.setValue("replayLoop", replayLoop);
+
         // FLIm processing
 		settings.setValue("flimBg", QString::number(flimBg, 'f', 2));
 		settings.setValue("flimWidthFactor", QString::number(flimWidthFactor, 'f', 2)); 
+		settings.setValue("flimChannels", flimChannels);
+		settings.setValue("flimUpsampleMode", flimUpsampleMode);
+		settings.setValue("flimMeanDelayTolerance", QString::number(flimMeanDelayTolerance, 'f', 3));
 		for (int i = 0; i < 4; i++)
 		{
 			settings.setValue(QString("flimChStartInd_%1").arg(i), flimChStartInd[i]);
@@ -211,9 +265,29 @@ public:
 	int imageStichingYStep;
 	int imageStichingMisSyncPos;
 
+	// Back-pressure of the acquisition pipeline
+	int flimBackPressure;
+	int flimDecimation;
+
+	// Acquisition backend (DAQ simulator settings)
+	int daqBackend;
+	float simDaqRate; // MS/s (0: free-running)
+	float simLifetime[3]; // nsec
+	float simJitter; // samples (peak-to-peak)
+	float simNoise; // ADC counts (rms)
+	float simSaturation; // ratio of saturated A-lines
+
+	// Raw capture replay
+	QString replayPath;
+	float replaySpeed; // relative to the recorded timing (0: as fast as possible)
+	bool replayLoop;
+
     // FLIm processing
 	float flimBg;
 	float flimWidthFactor;
+	int flimChannels;
+	int flimUpsampleMode;
+	float flimMeanDelayTolerance;
 	int flimChStartInd[4];
     float flimDelayOffset[3];
 
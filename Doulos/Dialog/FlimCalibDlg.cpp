@@ -25,6 +25,8 @@ FlimCalibDlg::FlimCalibDlg(QWidget *parent) :
     m_pDeviceControlTab = dynamic_cast<QDeviceControlTab*>(parent);
     m_pConfig = m_pDeviceControlTab->getStreamTab()->getMainWnd()->m_pConfiguration;
     m_pFLIm = m_pDeviceControlTab->getStreamTab()->getOperationTab()->getDataAcq()->getFLIm();
+    m_pFLIm->_resize.pulse_view = true;
+    m_pFLIm->calib_copy = true;
 		
 
     // Create layout
@@ -44,6 +46,9 @@ FlimCalibDlg::~FlimCalibDlg()
 {
     if (m_pHistogramIntensity) delete m_pHistogramIntensity;
     if (m_pHistogramLifetime) delete m_pHistogramLifetime;
+    m_pFLIm->_resize.spline_view = false;
+    m_pFLIm->_resize.pulse_view = false;
+    m_pFLIm->calib_copy = false;
 }
 
 void FlimCalibDlg::keyPressEvent(QKeyEvent *e)
@@ -60,7 +65,7 @@ void FlimCalibDlg::createPulseView()
     pGridLayout_PulseView->setSpacing(2);
 
     // Create widgets for FLIM pulse view
-    m_pScope_PulseView = new QScope({ 0, (double)m_pFLIm->_resize.crop_src.size(0) }, { -POWER_2(12), POWER_2(15) },
+    m_pScope_PulseView = new QScope({ 0, (double)((m_pFLIm->_resize.nx > 0) ? m_pFLIm->_resize.nx : 0) }, { -POWER_2(12), POWER_2(15) },
                                     2, 2, 1, 1, 0, 0, "", "", true);
     m_pScope_PulseView->getRender()->m_bMaskUse = false;
     m_pScope_PulseView->setMinimumHeight(180);
@@ -135,6 +140,15 @@ void FlimCalibDlg::createCalibWidgets()
     m_pLineEdit_Background->setText(QString::number(m_pFLIm->_params.bg, 'f', 2));
     m_pLineEdit_Background->setFixedWidth(60);
     m_pLineEdit_Background->setAlignment(Qt::AlignCenter);
+
+    m_pLabel_UpsampleMode = new QLabel("Up-sampling ", this);
+    m_pComboBox_UpsampleMode = new QComboBox(this);
+    m_pComboBox_UpsampleMode->addItem("MKL Spline");
+    m_pComboBox_UpsampleMode->addItem("Spline Matrix");
+    m_pComboBox_UpsampleMode->addItem("Fused Spline-FIR");
+    m_pComboBox_UpsampleMode->addItem("Fused (ROI only)");
+    m_pComboBox_UpsampleMode->setCurrentIndex(m_pFLIm->_params.upsample_mode);
+    m_pLabel_UpsampleMode->setBuddy(m_pComboBox_UpsampleMode);
 		
     m_pLabel_ChStart = new QLabel("Channel Start", this);
     m_pLabel_DelayTimeOffset = new QLabel("Delay Time Offset", this);
@@ -186,7 +200,13 @@ void FlimCalibDlg::createCalibWidgets()
     pHBoxLayout_Background->addWidget(m_pPushButton_CaptureBackground);
     pHBoxLayout_Background->addWidget(m_pLineEdit_Background);
 	
-    pGridLayout_PulseView->addItem(new QSpacerItem(0, 0, QSizePolicy::Expanding, QSizePolicy::Fixed), 0, 0, 1, 3);
+    QHBoxLayout *pHBoxLayout_UpsampleMode = new QHBoxLayout;
+    pHBoxLayout_UpsampleMode->setSpacing(2);
+    pHBoxLayout_UpsampleMode->addWidget(m_pLabel_UpsampleMode);
+    pHBoxLayout_UpsampleMode->addWidget(m_pComboBox_UpsampleMode);
+    pHBoxLayout_UpsampleMode->addItem(new QSpacerItem(0, 0, QSizePolicy::Expanding, QSizePolicy::Fixed));
+
+    pGridLayout_PulseView->addItem(pHBoxLayout_UpsampleMode, 0, 0, 1, 3);
     pGridLayout_PulseView->addItem(pHBoxLayout_Background, 0, 3, 1, 3);
     pGridLayout_PulseView->addItem(new QSpacerItem(0, 0, QSizePolicy::Fixed, QSizePolicy::Fixed), 0, 6);
 
@@ -212,6 +232,7 @@ void FlimCalibDlg::createCalibWidgets()
     // Connect
     connect(m_pPushButton_CaptureBackground, SIGNAL(clicked(bool)), this, SLOT(captureBackground()));
     connect(m_pLineEdit_Background, SIGNAL(textChanged(const QString &)), this, SLOT(captureBackground(const QString &)));
+    connect(m_pComboBox_UpsampleMode, SIGNAL(currentIndexChanged(int)), this, SLOT(changeUpsampleMode(int)));
     connect(m_pSpinBox_ChStart[0], SIGNAL(valueChanged(double)), this, SLOT(resetChStart0(double)));
     connect(m_pSpinBox_ChStart[1], SIGNAL(valueChanged(double)), this, SLOT(resetChStart1(double)));
     connect(m_pSpinBox_ChStart[2], SIGNAL(valueChanged(double)), this, SLOT(resetChStart2(double)));
@@ -333,9 +354,27 @@ void FlimCalibDlg::drawRoiPulse(FLImProcess* pFLIm, int aline)
 {
     // Reset pulse view (if necessary)
     static int roi_width = 0;
-    np::FloatArray2 data0((!m_pCheckBox_SplineView->isChecked()) ? pFLIm->_resize.mask_src : pFLIm->_resize.ext_src);
-    np::FloatArray2 data(data0.size(0), data0.size(1));
-    memcpy(data.raw_ptr(), data0.raw_ptr(), sizeof(float) * data0.length());
+
+    // Pulse of the first A-line, its mean delays & the planes of the emission channel from the copy kept by the processing thread
+    np::FloatArray data, mask, scanIntensity, scanLifetime;
+    float md[4];
+    {
+        std::unique_lock<std::mutex> lock(pFLIm->calib_mtx);
+        const FlimFrameResult& calib = pFLIm->calib;
+        if ((calib.alines == 0) || (pFLIm->calib_pulse.length() == 0)) return;
+        data = np::FloatArray(pFLIm->calib_pulse.length());
+        mask = np::FloatArray(pFLIm->calib_mask.length());
+        memcpy(data.raw_ptr(), pFLIm->calib_pulse.raw_ptr(), sizeof(float) * data.length());
+        memcpy(mask.raw_ptr(), pFLIm->calib_mask.raw_ptr(), sizeof(float) * mask.length());
+
+        for (int i = 0; i < 4; i++)
+            md[i] = calib.mean_delay(i)[aline];
+        scanIntensity = np::FloatArray(calib.alines);
+        scanLifetime = np::FloatArray(calib.alines);
+        memcpy(scanIntensity.raw_ptr(), calib.intensity(m_pConfig->flimEmissionChannel), sizeof(float) * calib.alines);
+        memcpy(scanLifetime.raw_ptr(), calib.lifetime(m_pConfig->flimEmissionChannel - 1), sizeof(float) * calib.alines);
+    }
+    int alines = scanIntensity.length();
 
     if (roi_width != data.size(0))
     {
@@ -351,16 +390,13 @@ void FlimCalibDlg::drawRoiPulse(FLImProcess* pFLIm, int aline)
         float factor = (!m_pCheckBox_SplineView->isChecked()) ? 1 : pFLIm->_resize.ActualFactor;
         for (int i = 0; i < 4; i++)
             m_pScope_PulseView->getRender()->m_pMdLineInd[i] =
-                    (pFLIm->_lifetime.mean_delay(aline, i) - pFLIm->_params.ch_start_ind[0]) * factor;
+                    (md[i] - pFLIm->_params.ch_start_ind[0]) * factor;
     }
 
     // ROI pulse
-    m_pScope_PulseView->drawData(&data(0, aline), pFLIm->_resize.pMask);
+    m_pScope_PulseView->drawData(data.raw_ptr(), mask.raw_ptr());
 
     // Histogram
-    float* scanIntensity = &pFLIm->_intensity.intensity(0, m_pConfig->flimEmissionChannel);
-    float* scanLifetime = &pFLIm->_lifetime.lifetime(0, m_pConfig->flimEmissionChannel - 1);
-
     (*m_pHistogramIntensity)(scanIntensity, m_pRenderArea_FluIntensity->m_pData, 
 		m_pConfig->flimIntensityRange[m_pConfig->flimEmissionChannel - 1].min, 
 		m_pConfig->flimIntensityRange[m_pConfig->flimEmissionChannel - 1].max);
@@ -378,10 +414,10 @@ void FlimCalibDlg::drawRoiPulse(FLImProcess* pFLIm, int aline)
     m_pColorbar_FluLifetime->resetColormap(ColorTable::colortable(m_pConfig->flimLifetimeColorTable));
 	
     Ipp32f mean, stdev;
-	FloatArray scanIntensity0(m_pConfig->flimAlines); memset(scanIntensity0, 0, sizeof(float) * m_pConfig->flimAlines);
-	FloatArray scanLifetime0(m_pConfig->flimAlines); memset(scanLifetime0, 0, sizeof(float) * m_pConfig->flimAlines);
+	FloatArray scanIntensity0(alines); memset(scanIntensity0, 0, sizeof(float) * alines);
+	FloatArray scanLifetime0(alines); memset(scanLifetime0, 0, sizeof(float) * alines);
 	int it_n = 0, lt_n = 0;
-	for (int i = 0; i < m_pConfig->flimAlines; i++)
+	for (int i = 0; i < alines; i++)
 	{
 		if (scanIntensity[i] != 0.0f) //(!std::isnan(scanIntensity[i]))
 			scanIntensity0[it_n++] = scanIntensity[i];
@@ -418,14 +454,27 @@ void FlimCalibDlg::showWindow(bool checked)
 
 void FlimCalibDlg::showMeanDelay(bool checked)
 {
+    // Mean delays of the first A-line from the copy kept by the processing thread
+    float md[4];
+    bool valid = false;
     if (checked)
+    {
+        std::unique_lock<std::mutex> lock(m_pFLIm->calib_mtx);
+        if (m_pFLIm->calib.alines > 0)
+        {
+            for (int i = 0; i < 4; i++)
+                md[i] = m_pFLIm->calib.mean_delay(i)[0];
+            valid = true;
+        }
+    }
+
+    if (valid)
     {
         float factor = (!m_pCheckBox_SplineView->isChecked()) ? 1 : m_pFLIm->_resize.ActualFactor;
 
         m_pScope_PulseView->setMeanDelayLine(4);
         for (int i = 0; i < 4; i++)
-            m_pScope_PulseView->getRender()->m_pMdLineInd[i] =
-                    (m_pFLIm->_lifetime.mean_delay(0, i) - m_pFLIm->_params.ch_start_ind[0]) * factor;
+            m_pScope_PulseView->getRender()->m_pMdLineInd[i] = (md[i] - m_pFLIm->_params.ch_start_ind[0]) * factor;
     }
     else
     {
@@ -436,6 +485,8 @@ void FlimCalibDlg::showMeanDelay(bool checked)
 
 void FlimCalibDlg::splineView(bool checked)
 {
+    m_pFLIm->_resize.spline_view = checked;
+
     if (m_pCheckBox_ShowWindow->isChecked())
     {
         int* ch_ind = (!checked) ? m_pFLIm->_params.ch_start_ind : m_pFLIm->_resize.ch_start_ind1;
@@ -499,6 +550,12 @@ void FlimCalibDlg::captureBackground(const QString &str)
     m_pConfig->flimBg = bg;
 }
 
+void FlimCalibDlg::changeUpsampleMode(int mode)
+{
+    m_pFLIm->_params.upsample_mode = mode;
+    m_pConfig->flimUpsampleMode = mode;
+}
+
 void FlimCalibDlg::resetChStart0(double start)
 {
     int ch_ind = (int)round(start / m_pFLIm->_params.samp_intv);
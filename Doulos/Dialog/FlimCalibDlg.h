@@ -128,6 +128,8 @@ public slots : // widgets
     void captureBackground();
     void captureBackground(const QString &);
 
+    void changeUpsampleMode(int);
+
     void resetChStart0(double);
     void resetChStart1(double);
     void resetChStart2(double);
@@ -170,6 +172,9 @@ private:
     QPushButton *m_pPushButton_CaptureBackground;
     QLineEdit *m_pLineEdit_Background;
 
+    QLabel *m_pLabel_UpsampleMode;
+    QComboBox *m_pComboBox_UpsampleMode;
+
     QLabel *m_pLabel_ChStart;
     QLabel *m_pLabel_DelayTimeOffset;
     QLabel *m_pLabel_Ch[4];
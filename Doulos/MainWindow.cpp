@@ -43,16 +43,16 @@ MainWindow::MainWindow(QWidget *parent) :
     m_pTabWidget->addTab(m_pStreamTab, tr("Real-Time Data Streaming"));
 	
     // Create status bar
-    QLabel *pStatusLabel_Temp1 = new QLabel(this); // System Message?
+    m_pStatusLabel_Pipeline = new QLabel(this); // Frame accounting of the acquisition pipeline
     m_pStatusLabel_ImagePos = new QLabel(QString("(%1, %2)").arg(0000, 4).arg(0000, 4), this);
     QLabel *pStatusLabel_Temp3 = new QLabel(this); // Device status?
 
-    pStatusLabel_Temp1->setFrameStyle(QFrame::Panel | QFrame::Sunken);
+    m_pStatusLabel_Pipeline->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     m_pStatusLabel_ImagePos->setFrameStyle(QFrame::Panel | QFrame::Sunken);
     pStatusLabel_Temp3->setFrameStyle(QFrame::Panel | QFrame::Sunken);
 
     // then add the widget to the status bar
-    statusBar()->addPermanentWidget(pStatusLabel_Temp1, 6);
+    statusBar()->addPermanentWidget(m_pStatusLabel_Pipeline, 6);
     statusBar()->addPermanentWidget(m_pStatusLabel_ImagePos, 1);
     statusBar()->addPermanentWidget(pStatusLabel_Temp3, 2);
 
@@ -67,6 +67,7 @@ MainWindow::MainWindow(QWidget *parent) :
     // Connect signal and slot
     connect(m_pTimer, SIGNAL(timeout()), this, SLOT(onTimer()));
     connect(m_pTabWidget, SIGNAL(currentChanged(int)), this, SLOT(changedTab(int)));
+    connect(m_pStreamTab, SIGNAL(sendPipelineStatus(const QString &)), m_pStatusLabel_Pipeline, SLOT(setText(const QString &)));
 }
 
 MainWindow::~MainWindow()
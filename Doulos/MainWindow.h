@@ -52,6 +52,7 @@ public:
     QResultTab *m_pResultTab;
 
     // Status bar
+    QLabel *m_pStatusLabel_Pipeline;
     QLabel *m_pStatusLabel_ImagePos;
 };
 
@@ -5,9 +5,11 @@
 #include <Doulos/MainWindow.h>
 #include <Doulos/QStreamTab.h>
 #include <Doulos/QDeviceControlTab.h>
+#include <Doulos/QVisualizationTab.h>
 
 #include <DataAcquisition/DataAcquisition.h>
 #include <DataAcquisition/ThreadManager.h>
+#include <DataAcquisition/RawCapture/RawCapture.h>
 #include <MemoryBuffer/MemoryBuffer.h>
 
 #include <iostream>
@@ -33,6 +35,13 @@ QOperationTab::QOperationTab(QWidget *parent) :
 		emit m_pStreamTab->sendStatusMessage(qmsg, is_error);
 	};
 
+	// Create raw capture object
+	m_pRawCapture = new RawCapture;
+	m_pRawCapture->SendStatusMessage += [&](const char* msg, bool is_error) {
+        QString qmsg = QString::fromUtf8(msg);
+		emit m_pStreamTab->sendStatusMessage(qmsg, is_error);
+	};
+
     // Create widgets for acquisition / recording / saving operation
     m_pToggleButton_Acquisition = new QPushButton(this);
     m_pToggleButton_Acquisition->setCheckable(true);
@@ -52,6 +61,10 @@ QOperationTab::QOperationTab(QWidget *parent) :
     m_pToggleButton_Saving->setText("&Save Recorded Data");
 	m_pToggleButton_Saving->setDisabled(true);
 
+	// Create a check box for raw frame capture
+	m_pCheckBox_RawCapture = new QCheckBox(this);
+	m_pCheckBox_RawCapture->setText("Capture &Raw Frames");
+
     // Create a progress bar (general purpose?)
     m_pProgressBar = new QProgressBar(this);
     m_pProgressBar->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Fixed);
@@ -71,6 +84,7 @@ QOperationTab::QOperationTab(QWidget *parent) :
 
     m_pVBoxLayout->addItem(pHBoxLayout);
     m_pVBoxLayout->addWidget(m_pProgressBar);
+	m_pVBoxLayout->addWidget(m_pCheckBox_RawCapture);
     m_pVBoxLayout->addStretch(1);
 
     setLayout(m_pVBoxLayout);
@@ -80,6 +94,7 @@ QOperationTab::QOperationTab(QWidget *parent) :
     connect(m_pToggleButton_Acquisition, SIGNAL(toggled(bool)), this, SLOT(operateDataAcquisition(bool)));
 	connect(m_pToggleButton_Recording, SIGNAL(toggled(bool)), this, SLOT(operateDataRecording(bool)));
     connect(m_pToggleButton_Saving, SIGNAL(toggled(bool)), this, SLOT(operateDataSaving(bool)));
+	connect(m_pCheckBox_RawCapture, SIGNAL(toggled(bool)), this, SLOT(operateRawCapture(bool)));
     connect(m_pMemoryBuffer, SIGNAL(finishedBufferAllocation()), this, SLOT(setAcqRecEnable()));
 	connect(m_pMemoryBuffer, SIGNAL(finishedWritingThread(bool)), this, SLOT(setSaveButtonDefault(bool)));
 	connect(m_pMemoryBuffer, SIGNAL(wroteSingleFrame(int)), m_pProgressBar, SLOT(setValue(int)));
@@ -89,6 +104,7 @@ QOperationTab::~QOperationTab()
 {
     if (m_pDataAcquisition) delete m_pDataAcquisition;
     if (m_pMemoryBuffer) delete m_pMemoryBuffer;
+	if (m_pRawCapture) delete m_pRawCapture;
 }
 
 
@@ -107,11 +123,18 @@ void QOperationTab::operateDataAcquisition(bool toggled)
 {
     if (toggled) // Start Data Acquisition
     {
+        // Leave the session review (the streaming buffers are visualized again)
+        m_pStreamTab->getVisualizationTab()->closeReview();
+
         if (m_pDataAcquisition->InitializeAcquistion())
         {
+            // Drain the buffers of the previous run (no frame or stop request is carried over)
+            m_pStreamTab->resetThreadingBuffers();
+
             // Start Thread Process
             m_pStreamTab->m_pThreadVisualization->startThreading();
-            m_pStreamTab->m_pThreadFlimProcess->startThreading();
+            for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+                m_pStreamTab->m_pThreadFlimProcess[i]->startThreading();
 
             // Start Data Acquisition
             if (m_pDataAcquisition->StartAcquisition())
@@ -166,9 +189,13 @@ void QOperationTab::operateDataAcquisition(bool toggled)
     {
         // Stop Thread Process
         m_pDataAcquisition->StopAcquisition();
-        m_pStreamTab->m_pThreadFlimProcess->stopThreading();
+        for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+            m_pStreamTab->m_pThreadFlimProcess[i]->stopThreading();
         m_pStreamTab->m_pThreadVisualization->stopThreading();
 
+		// Finish raw capture
+		m_pCheckBox_RawCapture->setChecked(false);
+
 		//std::thread deallocate_writing_buffer([&]() {
 		//	m_pMemoryBuffer->deallocateWritingBuffer();
 		//});
@@ -258,6 +285,34 @@ void QOperationTab::operateDataSaving(bool toggled)
     }
 }
 
+void QOperationTab::operateRawCapture(bool toggled)
+{
+	if (toggled) // Start Raw Capture
+	{
+		QString fileName = QFileDialog::getSaveFileName(nullptr, "Capture raw frames as...", "", "FLIm raw capture (*.raw)");
+		if (fileName == "")
+		{
+			m_pCheckBox_RawCapture->setChecked(false);
+			return;
+		}
+
+		// Configuration snapshot
+		m_pConfig->setConfigFile("Doulos.ini");
+		QByteArray config;
+		QFile ini("Doulos.ini");
+		if (ini.open(QIODevice::ReadOnly))
+		{
+			config = ini.readAll();
+			ini.close();
+		}
+
+		if (!m_pRawCapture->open(fileName, m_pConfig->flimScans, m_pConfig->flimAlines, config))
+			m_pCheckBox_RawCapture->setChecked(false);
+	}
+	else // Stop Raw Capture
+		m_pRawCapture->close();
+}
+
 
 void QOperationTab::setAcqRecEnable()
 {
@@ -10,6 +10,7 @@ class Configuration;
 
 class DataAcquisition;
 class MemoryBuffer;
+class RawCapture;
 
 
 class QOperationTab : public QDialog
@@ -38,6 +39,7 @@ private slots:
 	void operateDataAcquisition(bool toggled);
 	void operateDataRecording(bool toggled);
     void operateDataSaving(bool toggled);
+	void operateRawCapture(bool toggled);
 
 public slots :
 	void setAcqRecEnable();
@@ -54,6 +56,7 @@ public:
 	// Data acquisition and memory operation object
     DataAcquisition* m_pDataAcquisition;
     MemoryBuffer* m_pMemoryBuffer;
+	RawCapture* m_pRawCapture;
 
 private:
 	// Layout
@@ -64,6 +67,7 @@ private:
 	QPushButton *m_pToggleButton_Recording;
     QPushButton *m_pToggleButton_Saving;
 	QProgressBar *m_pProgressBar;
+	QCheckBox *m_pCheckBox_RawCapture;
 };
 
 #endif // QOPERATIONTAB_H
@@ -12,6 +12,7 @@
 #include <DataAcquisition/ThreadManager.h>
 
 #include <DataAcquisition/FLImProcess/FLImProcess.h>
+#include <DataAcquisition/RawCapture/RawCapture.h>
 
 #include <DeviceControl/GalvoScan/GalvoScan.h>
 #include <DeviceControl/ZaberStage/ZaberStage.h>
@@ -19,12 +20,13 @@
 #include <MemoryBuffer/MemoryBuffer.h>
 
 #include <iostream>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 
 
 QStreamTab::QStreamTab(QWidget *parent) :
-    QDialog(parent)
+    QDialog(parent), m_reorderFlimVisualization(m_syncFlimVisualization)
 {
 	// Set main window objects
     m_pMainWnd = dynamic_cast<MainWindow*>(parent);
@@ -135,6 +137,24 @@ QStreamTab::QStreamTab(QWidget *parent) :
 	m_pLineEdit_MisSyncPos->setAlignment(Qt::AlignCenter);
 	m_pLineEdit_MisSyncPos->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 	m_pLineEdit_MisSyncPos->setDisabled(true);
+
+	// Back-pressure policy
+	m_pLabel_BackPressure = new QLabel("Back-Pressure", this);
+	m_pComboBox_BackPressure = new QComboBox(this);
+	m_pComboBox_BackPressure->addItem("Drop Newest");
+	m_pComboBox_BackPressure->addItem("Drop Oldest");
+	m_pComboBox_BackPressure->addItem("Block");
+	m_pComboBox_BackPressure->addItem("Decimate");
+	m_pComboBox_BackPressure->setCurrentIndex(m_pConfig->flimBackPressure);
+
+	m_pLabel_Decimation = new QLabel("  every", this);
+	m_pLineEdit_Decimation = new QLineEdit(this);
+	m_pLineEdit_Decimation->setFixedWidth(25);
+	m_pLineEdit_Decimation->setText(QString::number(m_pConfig->flimDecimation));
+	m_pLineEdit_Decimation->setAlignment(Qt::AlignCenter);
+	m_pLineEdit_Decimation->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
+	m_pLabel_Decimation->setEnabled(m_pConfig->flimBackPressure == BACKPRESSURE_DECIMATE);
+	m_pLineEdit_Decimation->setEnabled(m_pConfig->flimBackPressure == BACKPRESSURE_DECIMATE);
 	
 
     QGridLayout *pGridLayout_ImageSize = new QGridLayout;
@@ -177,6 +197,17 @@ QStreamTab::QStreamTab(QWidget *parent) :
 
 	pGridLayout_ImageSize->addItem(pGridLayout_ImageStitching, 5, 0, 1, 4);
 
+	QHBoxLayout *pHBoxLayout_BackPressure = new QHBoxLayout;
+	pHBoxLayout_BackPressure->setSpacing(2);
+
+	pHBoxLayout_BackPressure->addWidget(m_pLabel_BackPressure);
+	pHBoxLayout_BackPressure->addItem(new QSpacerItem(0, 0, QSizePolicy::MinimumExpanding, QSizePolicy::Fixed));
+	pHBoxLayout_BackPressure->addWidget(m_pComboBox_BackPressure);
+	pHBoxLayout_BackPressure->addWidget(m_pLabel_Decimation);
+	pHBoxLayout_BackPressure->addWidget(m_pLineEdit_Decimation);
+
+	pGridLayout_ImageSize->addItem(pHBoxLayout_BackPressure, 6, 0, 1, 4);
+
 
     // Create group boxes for streaming objects
     m_pGroupBox_OperationTab = new QGroupBox();
@@ -202,12 +233,23 @@ QStreamTab::QStreamTab(QWidget *parent) :
     m_pGroupBox_ImageSizeTab->setFixedWidth(332);
 	
     // Create thread managers for data processing
-    m_pThreadFlimProcess = new ThreadManager("FLIm image process");
+    for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+    {
+        char name[256];
+        sprintf(name, "FLIm image process #%d", i);
+        m_pThreadFlimProcess[i] = new ThreadManager(name);
+    }
     m_pThreadVisualization = new ThreadManager("Visualization process");
 
-    // Create buffers for threading operation
-    m_syncFlimProcessing.allocate_queue_buffer(m_pConfig->flimScans, m_pConfig->flimAlines, PROCESSING_BUFFER_SIZE); // FLIm Processing
-    m_syncFlimVisualization.allocate_queue_buffer(11, m_pConfig->flimAlines, PROCESSING_BUFFER_SIZE); // FLIm Visualization
+    // Create buffers for threading operation (PROCESSING_BUFFER_SIZE is split among the workers)
+    int numa_nodes = np::frame_allocator::numa_nodes();
+    for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+    {
+        if (numa_nodes > 1) // the pulse frames of each worker on its own node (the worker binds itself to it)
+            m_syncFlimProcessing[i].numa_node = i % numa_nodes;
+        m_syncFlimProcessing[i].allocate_queue_object(PROCESSING_BUFFER_SIZE / FLIM_PROCESSING_WORKERS, m_pConfig->flimScans, m_pConfig->flimAlines); // FLIm Processing
+        m_syncFlimVisualization[i].allocate_queue_object(PROCESSING_BUFFER_SIZE / FLIM_PROCESSING_WORKERS, m_pConfig->flimAlines); // FLIm Visualization
+    }
 	
     // Set signal object
     setFlimAcquisitionCallback();
@@ -237,12 +279,15 @@ QStreamTab::QStreamTab(QWidget *parent) :
 	connect(m_pLineEdit_XStep, SIGNAL(textChanged(const QString &)), this, SLOT(changeStitchingXStep(const QString &)));
 	connect(m_pLineEdit_YStep, SIGNAL(textChanged(const QString &)), this, SLOT(changeStitchingYStep(const QString &)));
 	connect(m_pLineEdit_MisSyncPos, SIGNAL(textChanged(const QString &)), this, SLOT(changeStitchingMisSyncPos(const QString &)));
+	connect(m_pComboBox_BackPressure, SIGNAL(currentIndexChanged(int)), this, SLOT(changeBackPressure(int)));
+	connect(m_pLineEdit_Decimation, SIGNAL(textChanged(const QString &)), this, SLOT(changeDecimation(const QString &)));
 }
 
 QStreamTab::~QStreamTab()
 {
     if (m_pThreadVisualization) delete m_pThreadVisualization;
-    if (m_pThreadFlimProcess) delete m_pThreadFlimProcess;
+    for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+        if (m_pThreadFlimProcess[i]) delete m_pThreadFlimProcess[i];
 }
 
 void QStreamTab::keyPressEvent(QKeyEvent *e)
@@ -270,6 +315,15 @@ void QStreamTab::setAveragingWidgets(bool enabled)
 	m_pLineEdit_Averaging->setEnabled(enabled);
 }
 
+void QStreamTab::resetThreadingBuffers()
+{
+	for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+	{
+		m_syncFlimProcessing[i].reset();
+		m_syncFlimVisualization[i].reset();
+	}
+}
+
 void QStreamTab::setFlimAcquisitionCallback()
 {
 	DataAcquisition* pDataAcq = m_pOperationTab->getDataAcq();
@@ -278,30 +332,89 @@ void QStreamTab::setFlimAcquisitionCallback()
         // Data transfer for FLIm processing
         const uint16_t* frame_ptr = frame.raw_ptr();
 
-        // Get buffer from threading queue
-        uint16_t* pulse_ptr = nullptr;
-        {
-            std::unique_lock<std::mutex> lock(m_syncFlimProcessing.mtx);
+		static std::chrono::steady_clock::time_point tick_start, tick_last;
+		static int frame_seq = 0;
+		if (frame_count == 0)
+		{
+			m_statsPipeline.reset();
+			tick_start = tick_last = std::chrono::steady_clock::now();
+			frame_seq = 0;
+		}
+		m_statsPipeline.acquired++;
 
-            if (!m_syncFlimProcessing.queue_buffer.empty())
-            {
-                pulse_ptr = m_syncFlimProcessing.queue_buffer.front();
-                m_syncFlimProcessing.queue_buffer.pop();
-            }
-        }
+		// Acquisition time & raw capture of every acquired frame (ahead of the back-pressure policy)
+		int64_t timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start).count();
+		if (m_pOperationTab->m_pRawCapture->isOpen())
+			m_pOperationTab->m_pRawCapture->push(frame_count, timestamp, frame_ptr);
+
+		if ((m_pConfig->flimBackPressure == BACKPRESSURE_DECIMATE) && (frame_count % m_pConfig->flimDecimation))
+		{
+			m_statsPipeline.decimated++;
+			return;
+		}
+
+        // Get buffer from threading queue of the worker in turn, or of the next worker with a free buffer
+		// (sequence number i always goes to worker i % FLIM_PROCESSING_WORKERS: the numbers passed over are skipped in visualization)
+        FlimPulseFrame* pulse_ptr = nullptr;
+		int skip = 0;
+		for (; skip < FLIM_PROCESSING_WORKERS; skip++)
+			if ((pulse_ptr = m_syncFlimProcessing[(frame_seq + skip) % FLIM_PROCESSING_WORKERS].get_buffer()) != nullptr)
+				break;
+
+		// Every worker is behind: the back-pressure policy on the worker in turn
+		if (pulse_ptr == nullptr)
+		{
+			skip = 0;
+			SyncRing<FlimPulseFrame>& sync = m_syncFlimProcessing[frame_seq % FLIM_PROCESSING_WORKERS];
+			switch (m_pConfig->flimBackPressure)
+			{
+			case BACKPRESSURE_DROP_OLDEST:
+				pulse_ptr = sync.take_oldest();
+				if (pulse_ptr != nullptr) m_statsPipeline.dropped++;
+				break;
+			case BACKPRESSURE_BLOCK:
+				pulse_ptr = sync.wait_buffer(BACKPRESSURE_BLOCK_TIMEOUT);
+				break;
+			default: // BACKPRESSURE_DROP_NEWEST, BACKPRESSURE_DECIMATE
+				break;
+			}
+		}
 
         if (pulse_ptr != nullptr)
         {
             // Body
-            memcpy(pulse_ptr, frame_ptr, sizeof(uint16_t) * m_pConfig->flimFrameSize);
+            memcpy(pulse_ptr->pulse.raw_ptr(), frame_ptr, sizeof(uint16_t) * m_pConfig->flimFrameSize);
+			frame_seq += skip;
+            pulse_ptr->frame_index = frame_seq++; // the next frame goes to the next worker
+            pulse_ptr->timestamp = timestamp;
 
             // Push the buffer to sync Queue
-            m_syncFlimProcessing.Queue_sync.push(pulse_ptr);
+            m_syncFlimProcessing[pulse_ptr->frame_index % FLIM_PROCESSING_WORKERS].push(pulse_ptr);
         }
-		(void)frame_count;
+		else
+			m_statsPipeline.dropped++;
+
+		// Pipeline status (updated every 1 sec)
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tick_last;
+		if (elapsed.count() > 1.0)
+		{
+			int queued = 0, high_water = 0, capacity = 0;
+			for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+			{
+				queued += m_syncFlimProcessing[i].queued();
+				high_water += m_syncFlimProcessing[i].high_water;
+				capacity += m_syncFlimProcessing[i].capacity();
+			}
+
+			emit sendPipelineStatus(QString("Frames: %1 acquired, %2 processed, %3 dropped, %4 decimated, %5 dropped in processing / Queue: %6 (max %7) of %8")
+				.arg(m_statsPipeline.acquired).arg(m_statsPipeline.processed.load()).arg(m_statsPipeline.dropped).arg(m_statsPipeline.decimated)
+				.arg(m_statsPipeline.dropped_processing.load()).arg(queued).arg(high_water).arg(capacity));
+			tick_last = std::chrono::steady_clock::now();
+		}
     });
     pDataAcq->ConnectDaqStopFlimData([&]() {
-        m_syncFlimProcessing.Queue_sync.push(nullptr);
+		for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+			m_syncFlimProcessing[i].stop();
     });
 
     pDataAcq->ConnectDaqSendStatusMessage([&](const char * msg, bool is_error) {
@@ -314,65 +427,104 @@ void QStreamTab::setFlimAcquisitionCallback()
 void QStreamTab::setFlimProcessingCallback()
 {
     // FLIm Process Signal Objects /////////////////////////////////////////////////////////////////////////////////////////
-    FLImProcess *pFLIm = m_pOperationTab->getDataAcq()->getFLIm();
-    m_pThreadFlimProcess->DidAcquireData += [&, pFLIm] (int frame_count) {
+    FLImProcess *pFLImPrimary = m_pOperationTab->getDataAcq()->getFLIm();
+    for (int k = 0; k < FLIM_PROCESSING_WORKERS; k++)
+    {
+        FLImProcess *pFLIm = m_pOperationTab->getDataAcq()->getFLIm(k);
+        m_pThreadFlimProcess[k]->DidAcquireData += [&, k, pFLIm, pFLImPrimary] (int frame_count) {
 
-        // Get the buffer from the previous sync Queue
-        uint16_t* pulse_data = m_syncFlimProcessing.Queue_sync.pop();
-        if (pulse_data != nullptr)
-        {
-            // Get buffers from threading queues
-            float* flim_ptr = nullptr;
+            // Run next to the pulse frames of this worker
+            if (frame_count == 0)
+                m_syncFlimProcessing[k].bind_consumer();
+
+            // Get the buffer from the previous sync Queue
+            FlimPulseFrame* pulse_data = m_syncFlimProcessing[k].pop();
+            if (pulse_data != nullptr)
             {
-                std::unique_lock<std::mutex> lock(m_syncFlimVisualization.mtx);
+                // Get buffers from threading queues
+                FlimFrameResult* flim_ptr = m_syncFlimVisualization[k].get_buffer();
 
-                if (!m_syncFlimVisualization.queue_buffer.empty())
+                if (flim_ptr != nullptr)
                 {
-                    flim_ptr = m_syncFlimVisualization.queue_buffer.front();
-                    m_syncFlimVisualization.queue_buffer.pop();
+                    // Follow the parameters of the primary object
+                    if (pFLIm != pFLImPrimary)
+                        pFLIm->syncParameters(*pFLImPrimary);
+
+                    // Body
+                    flim_ptr->frame_index = pulse_data->frame_index;
+                    flim_ptr->timestamp = pulse_data->timestamp;
+
+                    (*pFLIm)(*flim_ptr, pulse_data->pulse);
+
+                    // Processing rate & mean delay iteration statistics of each worker (updated every 5 sec)
+                    static std::chrono::steady_clock::time_point tick_last[FLIM_PROCESSING_WORKERS];
+                    static int frames_processed[FLIM_PROCESSING_WORKERS];
+                    static int iter_hist[FLIM_PROCESSING_WORKERS][MEAN_DELAY_MAX_ITER + 1];
+                    if (frame_count == 0)
+                    {
+                        tick_last[k] = std::chrono::steady_clock::now(); frames_processed[k] = 0;
+                        memset(iter_hist[k], 0, sizeof(iter_hist[k]));
+                    }
+                    frames_processed[k]++;
+                    for (int i = 0; i <= MEAN_DELAY_MAX_ITER; i++)
+                        iter_hist[k][i] += pFLIm->_lifetime.iter_hist[i];
+
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tick_last[k];
+                    if (elapsed.count() > 5.0)
+                    {
+                        char msg[256];
+                        int len = sprintf(msg, "[FLIm Processing #%d] %.2f fps, mean delay iterations", k, (double)frames_processed[k] / elapsed.count());
+
+                        int total = 0;
+                        for (int i = 0; i <= MEAN_DELAY_MAX_ITER; i++)
+                            total += iter_hist[k][i];
+                        for (int i = 0; i <= MEAN_DELAY_MAX_ITER; i++)
+                            if (iter_hist[k][i])
+                                len += sprintf(msg + len, " %d:%.1f%%", i, 100.0 * (double)iter_hist[k][i] / (double)total);
+                        m_pThreadFlimProcess[k]->SendStatusMessage(msg, false);
+
+                        tick_last[k] = std::chrono::steady_clock::now();
+                        frames_processed[k] = 0;
+                        memset(iter_hist[k], 0, sizeof(iter_hist[k]));
+                    }
+
+                    // Transfer to FLIm calibration dlg (only the primary object keeps its copy)
+                    if ((pFLIm == pFLImPrimary) && !(frame_count % RENEWAL_COUNT))
+                        if (m_pDeviceControlTab->getFlimCalibDlg())
+                            emit m_pDeviceControlTab->getFlimCalibDlg()->plotRoiPulse(pFLIm, 0);
+
+                    // Push the buffers to sync Queues
+                    m_syncFlimVisualization[k].push(flim_ptr);
+                    m_statsPipeline.processed++;
+
+                    // Return (push) the buffer to the previous threading queue
+                    m_syncFlimProcessing[k].return_buffer(pulse_data);
                 }
-            }
-
-            if (flim_ptr != nullptr)
-            {
-                // Body
-                np::FloatArray2 intensity (flim_ptr + 0 * m_pConfig->flimAlines, m_pConfig->flimAlines, 4);
-                np::FloatArray2 mean_delay(flim_ptr + 4 * m_pConfig->flimAlines, m_pConfig->flimAlines, 4);
-                np::FloatArray2 lifetime  (flim_ptr + 8 * m_pConfig->flimAlines, m_pConfig->flimAlines, 3);
-                np::Uint16Array2 pulse(pulse_data, m_pConfig->flimScans, m_pConfig->flimAlines);
-
-                (*pFLIm)(intensity, mean_delay, lifetime, pulse);
-
-                // Transfer to FLIm calibration dlg
-                if (!(frame_count % RENEWAL_COUNT))
-                    if (m_pDeviceControlTab->getFlimCalibDlg())
-                        emit m_pDeviceControlTab->getFlimCalibDlg()->plotRoiPulse(pFLIm, 0);
-
-                // Push the buffers to sync Queues
-                m_syncFlimVisualization.Queue_sync.push(flim_ptr);
-
-                // Return (push) the buffer to the previous threading queue
+                else
                 {
-                    std::unique_lock<std::mutex> lock(m_syncFlimProcessing.mtx);
-                    m_syncFlimProcessing.queue_buffer.push(pulse_data);
+                    // Visualization is behind: drop the frame
+                    m_syncFlimProcessing[k].return_buffer(pulse_data);
+                    m_statsPipeline.dropped_processing++;
                 }
             }
-        }
-        else
-            m_pThreadFlimProcess->_running = false;
-
-        (void)frame_count;
-    };
+            else
+            {
+                // The last frame of this worker is pushed: the visualization gets nullptr after it
+                m_syncFlimVisualization[k].stop();
+                m_pThreadFlimProcess[k]->_running = false;
+            }
+        };
 
-    m_pThreadFlimProcess->DidStopData += [&]() {
-        m_syncFlimVisualization.Queue_sync.push(nullptr);
-    };
+        m_pThreadFlimProcess[k]->DidStopData += [&, k]() {
+            // None (the worker finishes after the acquisition stops its processing ring)
+        };
 
-    m_pThreadFlimProcess->SendStatusMessage += [&](const char* msg, bool is_error) {
-        if (is_error) m_pOperationTab->setAcquisitionButton(false);
-        QString qmsg = QString::fromUtf8(msg);
-        emit sendStatusMessage(qmsg, is_error);
-    };
+        m_pThreadFlimProcess[k]->SendStatusMessage += [&](const char* msg, bool is_error) {
+            if (is_error) m_pOperationTab->setAcquisitionButton(false);
+            QString qmsg = QString::fromUtf8(msg);
+            emit sendStatusMessage(qmsg, is_error);
+        };
+    }
 }
 
 void QStreamTab::setVisualizationCallback()
@@ -388,8 +540,13 @@ void QStreamTab::setVisualizationCallback()
 		static int averageCount = 1;
 		if (frame_count == 0) averageCount = 1;
 
-		// Get the buffers from the previous sync Queues
-		float* flim_data = m_syncFlimVisualization.Queue_sync.pop();
+		// Get the buffers from the previous sync Queues in the frame order (one pending result per worker)
+		if (frame_count == 0)
+			m_reorderFlimVisualization.reset();
+
+		int worker = 0;
+		FlimFrameResult* flim_data = m_reorderFlimVisualization.pop(worker);
+
 		if (flim_data != nullptr)
 		{
 			// Body
@@ -407,16 +564,14 @@ void QStreamTab::setVisualizationCallback()
 				}
 
 				// Data copy
-				np::FloatArray2 intensity(flim_data + 0 * m_pConfig->flimAlines, m_pConfig->flimAlines, 4);
-				np::FloatArray2 lifetime(flim_data + 8 * m_pConfig->flimAlines, m_pConfig->flimAlines, 3);
-
 				for (int i = 0; i < 3; i++)
 				{
-					ippsAdd_32f_I(&intensity(0, i + 1), &m_pTempIntensity(0, i * m_pConfig->imageSize) + writtenSamples, m_pConfig->flimAlines);
-					ippsAdd_32f_I(&lifetime(0, i), &m_pTempLifetime(0, i * m_pConfig->imageSize) + writtenSamples, m_pConfig->flimAlines);
+					const float* intensity = flim_data->intensity(i + 1);
+					ippsAdd_32f_I(intensity, &m_pTempIntensity(0, i * m_pConfig->imageSize) + writtenSamples, m_pConfig->flimAlines);
+					ippsAdd_32f_I(flim_data->lifetime(i), &m_pTempLifetime(0, i * m_pConfig->imageSize) + writtenSamples, m_pConfig->flimAlines);
 					
 					for (int j = 0; j < m_pConfig->flimAlines; j++)
-						if (intensity(j, i + 1) != 0.0f)
+						if (intensity[j] != 0.0f)
 							(*(&m_pNonNaNIndex(0, i * m_pConfig->imageSize) + writtenSamples + j))++;
 				}
 				writtenSamples += m_pConfig->flimAlines;
@@ -466,24 +621,12 @@ void QStreamTab::setVisualizationCallback()
 						// Buffering (When recording)
 						if (pMemBuff->m_bIsRecording)
 						{
-							// Get buffer from writing queue
-							float* image_ptr = pMemBuff->m_vectorWritingImageBuffer.at(pMemBuff->m_nRecordedFrame);
-
-							if (image_ptr != nullptr)
+							// Spool the frame through a recycled writing buffer
+							if (!pMemBuff->pushImage(m_pVisualizationTab->m_vecVisIntensity, m_pVisualizationTab->m_vecVisLifetime))
 							{
-								// Body (Copying the frame data)
-								for (int i = 0; i < 3; i++)
-								{
-									memcpy(image_ptr + i * m_pVisualizationTab->m_vecVisIntensity.at(i).length(), m_pVisualizationTab->m_vecVisIntensity.at(i).raw_ptr(),
-										sizeof(float) * m_pVisualizationTab->m_vecVisIntensity.at(i).length());
-									memcpy(image_ptr + (i + 3) * m_pVisualizationTab->m_vecVisLifetime.at(i).length(), m_pVisualizationTab->m_vecVisLifetime.at(i).raw_ptr(),
-										sizeof(float) * m_pVisualizationTab->m_vecVisLifetime.at(i).length());
-								}
-								pMemBuff->increaseRecordedFrame();
+								// Not taken (the spool is behind): the stage stays, and the next average is recorded in its place
 							}
-
-							// Finish recording when the buffer is full
-							if (m_pCheckBox_StitchingMode->isChecked())
+							else if (m_pCheckBox_StitchingMode->isChecked()) // Finish recording when the buffer is full
 							{
 								getDeviceControlTab()->getFlimLaserTrigControl()->setChecked(false);
 
@@ -537,17 +680,26 @@ void QStreamTab::setVisualizationCallback()
 			}
 
 			// Return (push) the buffer to the previous threading queue
-			{
-				std::unique_lock<std::mutex> lock(m_syncFlimVisualization.mtx);
-				m_syncFlimVisualization.queue_buffer.push(flim_data);
-			}
+			m_syncFlimVisualization[worker].return_buffer(flim_data);
 		}
 		else
 			m_pThreadVisualization->_running = false;
     };
 
     m_pThreadVisualization->DidStopData += [&]() {
-        // None
+		// Frame accounting of the run (the acquisition and the processing workers are joined)
+		int high_water = 0, capacity = 0;
+		for (int i = 0; i < FLIM_PROCESSING_WORKERS; i++)
+		{
+			high_water += m_syncFlimProcessing[i].high_water;
+			capacity += m_syncFlimProcessing[i].capacity();
+		}
+
+		char msg[256];
+		sprintf(msg, "[FLIm Acquisition] %d frames acquired, %d processed, %d dropped, %d decimated, %d dropped in processing (buffer high-water: %d / %d)",
+			m_statsPipeline.acquired, m_statsPipeline.processed.load(), m_statsPipeline.dropped, m_statsPipeline.decimated,
+			m_statsPipeline.dropped_processing.load(), high_water, capacity);
+		emit sendStatusMessage(QString::fromUtf8(msg), false);
     };
 
     m_pThreadVisualization->SendStatusMessage += [&](const char* msg, bool is_error) {
@@ -626,8 +778,6 @@ void QStreamTab::changeStitchingXStep(const QString &str)
 	m_pConfig->imageStichingXStep = str.toInt();
 	if (m_pConfig->imageStichingXStep < 1)
 		m_pLineEdit_XStep->setText(QString::number(1));
-
-	m_pOperationTab->m_pMemoryBuffer->allocateWritingBuffer();
 }
 
 void QStreamTab::changeStitchingYStep(const QString &str)
@@ -635,8 +785,6 @@ void QStreamTab::changeStitchingYStep(const QString &str)
 	m_pConfig->imageStichingYStep = str.toInt();
 	if (m_pConfig->imageStichingYStep < 1)
 		m_pLineEdit_YStep->setText(QString::number(1));
-
-	m_pOperationTab->m_pMemoryBuffer->allocateWritingBuffer();
 }
 
 void QStreamTab::changeStitchingMisSyncPos(const QString &str)
@@ -657,6 +805,21 @@ void QStreamTab::changeStitchingMisSyncPos(const QString &str)
 	m_pVisualizationTab->visualizeImage();
 }
 
+void QStreamTab::changeBackPressure(int policy)
+{
+	m_pConfig->flimBackPressure = policy;
+
+	m_pLabel_Decimation->setEnabled(policy == BACKPRESSURE_DECIMATE);
+	m_pLineEdit_Decimation->setEnabled(policy == BACKPRESSURE_DECIMATE);
+}
+
+void QStreamTab::changeDecimation(const QString &str)
+{
+	int decimation = str.toInt();
+	if (decimation >= 2) // read by the acquisition thread; an incomplete entry is not applied
+		m_pConfig->flimDecimation = decimation;
+}
+
 void QStreamTab::processMessage(QString qmsg, bool is_error)
 {
 	m_pListWidget_MsgWnd->addItem(qmsg);
@@ -5,10 +5,14 @@
 #include <QtWidgets>
 #include <QtCore>
 
+#include <atomic>
+
 #include <Doulos/Configuration.h>
 
 #include <Common/array.h>
-#include <Common/SyncObject.h>
+#include <Common/SyncRing.h>
+
+#include <DataAcquisition/FLImProcess/FlimFrameResult.h>
 
 class MainWindow;
 class QOperationTab;
@@ -23,6 +27,32 @@ class FLImProcess;
 #define IMAGE_SIZE_512  512
 #define IMAGE_SIZE_1024 1024
 
+#define BACKPRESSURE_DROP_NEWEST	0 // discard the incoming frame
+#define BACKPRESSURE_DROP_OLDEST	1 // discard the oldest frame waiting for processing
+#define BACKPRESSURE_BLOCK			2 // hold the DAQ thread until a buffer is free
+#define BACKPRESSURE_DECIMATE		3 // process every N-th frame only (drop-newest otherwise)
+
+#define BACKPRESSURE_BLOCK_TIMEOUT	1000 // msec
+
+
+struct PipelineStats
+{
+	// DAQ thread
+	int acquired = 0;
+	int dropped = 0; // by the back-pressure policy
+	int decimated = 0;
+
+	// Processing workers
+	std::atomic<int> processed{ 0 }; // finished and handed to the visualization
+	std::atomic<int> dropped_processing{ 0 }; // no free visualization buffer
+
+	void reset()
+	{
+		acquired = 0; dropped = 0; decimated = 0;
+		processed = 0; dropped_processing = 0;
+	}
+};
+
 
 class QStreamTab : public QDialog
 {
@@ -52,6 +82,7 @@ public:
     void setWidgetsText();
     void setImageSizeWidgets(bool enabled);
 	void setAveragingWidgets(bool enabled);
+	void resetThreadingBuffers(); // before the threads are started
 
 private:		
 // Set thread callback objects
@@ -66,10 +97,13 @@ private slots:
 	void changeStitchingXStep(const QString &);
 	void changeStitchingYStep(const QString &);
 	void changeStitchingMisSyncPos(const QString &);
+	void changeBackPressure(int);
+	void changeDecimation(const QString &);
     void processMessage(QString, bool);
 
 signals:
     void sendStatusMessage(QString, bool);
+	void sendPipelineStatus(const QString &);
 
 // Variables ////////////////////////////////////////////
 private:
@@ -91,13 +125,17 @@ public:
 
 public:
     // Thread manager objects
-    ThreadManager* m_pThreadFlimProcess;
+    ThreadManager* m_pThreadFlimProcess[FLIM_PROCESSING_WORKERS];
     ThreadManager* m_pThreadVisualization;
 
 private:
-    // Thread synchronization objects
-    SyncObject<uint16_t> m_syncFlimProcessing;
-    SyncObject<float> m_syncFlimVisualization;
+    // Thread synchronization objects (a pair per processing worker, dealt frames in turn)
+    SyncRing<FlimPulseFrame> m_syncFlimProcessing[FLIM_PROCESSING_WORKERS];
+    SyncRing<FlimFrameResult> m_syncFlimVisualization[FLIM_PROCESSING_WORKERS];
+    SyncReorder<FlimFrameResult, FLIM_PROCESSING_WORKERS> m_reorderFlimVisualization; // results of the workers in the frame order
+
+	// Frame accounting of the acquisition callback
+	PipelineStats m_statsPipeline;
 
 private:
     // Layout
@@ -134,6 +172,12 @@ private:
 	QLabel *m_pLabel_YStep;
 	QLineEdit *m_pLineEdit_MisSyncPos;
 	QLabel *m_pLabel_MisSyncPos;
+
+	// Back-pressure policy
+	QLabel *m_pLabel_BackPressure;
+	QComboBox *m_pComboBox_BackPressure;
+	QLabel *m_pLabel_Decimation;
+	QLineEdit *m_pLineEdit_Decimation;
 };
 
 #endif // QSTREAMTAB_H
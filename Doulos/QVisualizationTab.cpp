@@ -12,6 +12,8 @@
 #include <DataAcquisition/DataAcquisition.h>
 #include <DataAcquisition/FLImProcess/FLImProcess.h>
 
+#include <MemoryBuffer/FlimSession.h>
+
 #include <ippcore.h>
 #include <ippi.h>
 #include <ipps.h>
@@ -19,7 +21,7 @@
 
 QVisualizationTab::QVisualizationTab(bool is_streaming, QWidget *parent) :
     QDialog(parent), m_pStreamTab(nullptr), m_pResultTab(nullptr),
-    m_pImgObjIntensity(nullptr), m_pImgObjLifetime(nullptr), m_pImgObjMerged(nullptr), m_pMedfilt(nullptr)
+    m_pImgObjIntensity(nullptr), m_pImgObjLifetime(nullptr), m_pImgObjMerged(nullptr), m_pMedfilt(nullptr), m_pSession(nullptr)
 {
     // Set configuration objects
 	if (is_streaming)
@@ -52,6 +54,10 @@ QVisualizationTab::QVisualizationTab(bool is_streaming, QWidget *parent) :
     // Create FLIM visualization option tab
     createFlimVisualizationOptionTab();
 
+	// Create session review tab
+	m_pSession = new FlimSession;
+	createReviewTab();
+
     // Set layout
     m_pGroupBox_VisualizationWidgets = new QGroupBox;
     m_pGroupBox_VisualizationWidgets->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
@@ -61,6 +67,7 @@ QVisualizationTab::QVisualizationTab(bool is_streaming, QWidget *parent) :
     pVBoxLayout->setSpacing(1);
 
     pVBoxLayout->addWidget(m_pGroupBox_FlimVisualization);
+	pVBoxLayout->addWidget(m_pGroupBox_Review);
 
     m_pGroupBox_VisualizationWidgets->setLayout(pVBoxLayout);
 
@@ -80,6 +87,7 @@ QVisualizationTab::~QVisualizationTab()
 	if (m_pImgObjMerged) delete m_pImgObjMerged;
 	
     if (m_pMedfilt) delete m_pMedfilt;
+	if (m_pSession) delete m_pSession;
 }
 
 
@@ -210,6 +218,39 @@ void QVisualizationTab::createFlimVisualizationOptionTab()
     connect(m_pLineEdit_LifetimeMin, SIGNAL(textEdited(const QString &)), this, SLOT(adjustFlimContrast()));
 }
 
+void QVisualizationTab::createReviewTab()
+{
+	// Create widgets for saved session review
+	m_pGroupBox_Review = new QGroupBox;
+	m_pGroupBox_Review->setSizePolicy(QSizePolicy::MinimumExpanding, QSizePolicy::Fixed);
+	m_pGroupBox_Review->setStyleSheet("QGroupBox{padding-top:15px; margin-top:-15px}");
+
+	m_pToggleButton_Review = new QPushButton(this);
+	m_pToggleButton_Review->setCheckable(true);
+	m_pToggleButton_Review->setText("Re&view Session...");
+
+	m_pSlider_ReviewFrame = new QSlider(Qt::Horizontal, this);
+	m_pSlider_ReviewFrame->setRange(0, 0);
+	m_pSlider_ReviewFrame->setDisabled(true);
+
+	m_pLabel_ReviewFrame = new QLabel(this);
+	m_pLabel_ReviewFrame->setFixedWidth(150);
+	m_pLabel_ReviewFrame->setAlignment(Qt::AlignVCenter | Qt::AlignRight);
+
+	// Set layout
+	QHBoxLayout *pHBoxLayout_Review = new QHBoxLayout;
+	pHBoxLayout_Review->setSpacing(3);
+	pHBoxLayout_Review->addWidget(m_pToggleButton_Review);
+	pHBoxLayout_Review->addWidget(m_pSlider_ReviewFrame);
+	pHBoxLayout_Review->addWidget(m_pLabel_ReviewFrame);
+
+	m_pGroupBox_Review->setLayout(pHBoxLayout_Review);
+
+	// Connect signal and slot
+	connect(m_pToggleButton_Review, SIGNAL(toggled(bool)), this, SLOT(operateReview(bool)));
+	connect(m_pSlider_ReviewFrame, SIGNAL(valueChanged(int)), this, SLOT(showReviewFrame(int)));
+}
+
 
 void QVisualizationTab::setObjects(int image_size)
 {
@@ -381,3 +422,101 @@ void QVisualizationTab::adjustFlimContrast()
 
     visualizeImage();
 }
+
+void QVisualizationTab::closeReview()
+{
+	if (m_pToggleButton_Review->isChecked())
+		m_pToggleButton_Review->setChecked(false);
+}
+
+void QVisualizationTab::operateReview(bool toggled)
+{
+	if (toggled) // Open a saved session
+	{
+		if (m_pStreamTab && m_pStreamTab->getOperationTab()->isAcquisitionButtonToggled())
+		{
+			emit m_pStreamTab->sendStatusMessage("Stop the acquisition to review a saved session.", false);
+			m_pToggleButton_Review->setChecked(false);
+			return;
+		}
+
+		QString fileName = QFileDialog::getOpenFileName(nullptr, "Review Session", "", "FLIm sessions (*.data *.flim)");
+		if (fileName == "")
+		{
+			m_pToggleButton_Review->setChecked(false);
+			return;
+		}
+
+		if (!m_pSession->open(fileName))
+		{
+			if (m_pStreamTab) emit m_pStreamTab->sendStatusMessage(m_pSession->errorString(), true);
+			m_pToggleButton_Review->setChecked(false);
+			return;
+		}
+
+		if (m_pSession->imageSize() != m_pConfig->imageSize)
+		{
+			if (m_pStreamTab) emit m_pStreamTab->sendStatusMessage(QString("Image size of the session (%1) differs from the current image size (%2).")
+				.arg(m_pSession->imageSize()).arg(m_pConfig->imageSize), true);
+			m_pSession->close();
+			m_pToggleButton_Review->setChecked(false);
+			return;
+		}
+
+		m_pToggleButton_Review->setText("Close Re&view");
+		m_pSlider_ReviewFrame->setRange(0, m_pSession->frames() - 1);
+		m_pSlider_ReviewFrame->setValue(0);
+		m_pSlider_ReviewFrame->setEnabled(true);
+		showReviewFrame(0);
+
+		if (m_pStreamTab) emit m_pStreamTab->sendStatusMessage(QString("Reviewing %1 (%2 frames)").arg(fileName).arg(m_pSession->frames()), false);
+	}
+	else // Back to the streaming buffers
+	{
+		if (!m_pSession->isOpen())
+			return;
+
+		m_pSession->close();
+
+		m_pToggleButton_Review->setText("Re&view Session...");
+		m_pSlider_ReviewFrame->setRange(0, 0);
+		m_pSlider_ReviewFrame->setDisabled(true);
+		m_pLabel_ReviewFrame->setText("");
+
+		setObjects(m_pConfig->imageSize);
+		visualizeImage();
+	}
+}
+
+void QVisualizationTab::showReviewFrame(int frame)
+{
+	if (!m_pSession->isOpen())
+		return;
+
+	// The image size was changed under review
+	if (m_pSession->imageSize() != m_pConfig->imageSize)
+	{
+		closeReview();
+		return;
+	}
+
+	// Views of the session planes in place of the streaming buffers (no copy for .data)
+	for (int i = 0; i < 3; i++)
+	{
+		m_vecVisIntensity.at(i) = m_pSession->intensity(frame, i);
+		m_vecVisLifetime.at(i) = m_pSession->lifetime(frame, i);
+	}
+
+	// Stitching tile of the frame (serpentine order of the stage scan)
+	QString label = QString("Frame %1 / %2").arg(frame + 1).arg(m_pSession->frames());
+	int x_step = m_pSession->xStep();
+	if (x_step * m_pSession->yStep() > 1)
+	{
+		int row = frame / x_step;
+		int col = (row % 2) ? x_step - 1 - frame % x_step : frame % x_step;
+		label += QString(" (%1, %2)").arg(col + 1).arg(row + 1);
+	}
+	m_pLabel_ReviewFrame->setText(label);
+
+	visualizeImage();
+}
@@ -22,6 +22,7 @@
 class QStreamTab;
 class QResultTab;
 class QImageView;
+class FlimSession;
 
 
 class QVisualizationTab : public QDialog
@@ -43,9 +44,11 @@ public:
 
 private:
     void createFlimVisualizationOptionTab();
+	void createReviewTab();
 
 public:
     void setObjects(int image_size);
+	void closeReview();
 
 public slots:
     void visualizeImage();
@@ -55,6 +58,8 @@ private slots:
     void changeEmissionChannel(int);
     void changeLifetimeColorTable(int);
     void adjustFlimContrast();
+	void operateReview(bool toggled);
+	void showReviewFrame(int frame);
 
 signals:
     void drawImage();
@@ -79,6 +84,9 @@ private:
 
 	medfilt* m_pMedfilt;
 
+	// Saved session under review
+	FlimSession* m_pSession;
+
 private:
     // Layout
     QVBoxLayout *m_pVBoxLayout;
@@ -114,6 +122,12 @@ private:
     QLineEdit *m_pLineEdit_LifetimeMin;
     QImageView *m_pImageView_IntensityColorbar;
     QImageView *m_pImageView_LifetimeColorbar;
+
+	// Session review widgets
+	QGroupBox *m_pGroupBox_Review;
+	QPushButton *m_pToggleButton_Review;
+	QSlider *m_pSlider_ReviewFrame;
+	QLabel *m_pLabel_ReviewFrame;
 };
 
 #endif // QVISUALIZATIONTAB_H
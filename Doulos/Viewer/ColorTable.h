@@ -0,0 +1,27 @@
+#ifndef COLORTABLE_H
+#define COLORTABLE_H
+
+#include <QString>
+#include <QVector>
+#include <QRgb>
+
+using ColorTableVector = QVector<QVector<QRgb>>;
+
+// Colour tables of the viewers & exported images (256 x RGB bytes, planar, per .colortable file)
+// Kept apart from QImageView so that the tools without widgets can load them.
+class ColorTable
+{
+public:
+	explicit ColorTable(const QString& dir = "ColorTable");
+
+public:
+	enum colortable { gray = 0, inv_gray, sepia, jet, parula, hot, fire, hsv, 
+		smart, blueorange, cool, gem, greenfireblue, ice, lifetime2, vessel, hsv1 }; //   colortable ̸ ߰ϱ
+	QVector<QString> m_cNameVector;
+	ColorTableVector m_colorTableVector;
+
+public:
+	static QVector<QRgb> read(const QString& fileName);
+};
+
+#endif // COLORTABLE_H
@@ -4,47 +4,6 @@
 #include <ipps.h>
 
 
-ColorTable::ColorTable()
-{
-	// Color table list	
-	m_cNameVector.push_back("gray");
-	m_cNameVector.push_back("invgray");
-	m_cNameVector.push_back("sepia");
-	m_cNameVector.push_back("jet");
-	m_cNameVector.push_back("parula");
-	m_cNameVector.push_back("hot");
-	m_cNameVector.push_back("fire");
-	m_cNameVector.push_back("hsv");
-	m_cNameVector.push_back("smart");
-	m_cNameVector.push_back("bor");
-	m_cNameVector.push_back("cool");
-	m_cNameVector.push_back("gem");
-	m_cNameVector.push_back("gfb");
-	m_cNameVector.push_back("ice");
-	m_cNameVector.push_back("lifetime2");
-	m_cNameVector.push_back("vessel");
-	m_cNameVector.push_back("hsv1");
-	// ο  ̸ ߰ ϱ
-
-	for (int i = 0; i < m_cNameVector.size(); i++)
-	{
-		QFile file("ColorTable/" + m_cNameVector.at(i) + ".colortable");
-		file.open(QIODevice::ReadOnly);
-		np::Uint8Array2 rgb(256, 3);
-		file.read(reinterpret_cast<char*>(rgb.raw_ptr()), sizeof(uint8_t) * rgb.length());
-		file.close();
-
-		QVector<QRgb> temp_vector;
-		for (int j = 0; j < 256; j++)
-		{
-			QRgb color = qRgb(rgb(j, 0), rgb(j, 1), rgb(j, 2));
-			temp_vector.push_back(color);
-		}
-		m_colorTableVector.push_back(temp_vector);
-	}
-}
-
-
 QImageView::QImageView(QWidget *parent) :
 	QDialog(parent)
 {
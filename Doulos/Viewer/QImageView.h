@@ -11,19 +11,8 @@
 
 #include <Common/array.h>
 #include <Common/callback.h>
-using ColorTableVector = QVector<QVector<QRgb>>;
+#include <Doulos/Viewer/ColorTable.h>
 
-class ColorTable
-{
-public:
-	explicit ColorTable();
-
-public:
-	enum colortable { gray = 0, inv_gray, sepia, jet, parula, hot, fire, hsv, 
-		smart, blueorange, cool, gem, greenfireblue, ice, lifetime2, vessel, hsv1 }; //   colortable ̸ ߰ϱ
-	QVector<QString> m_cNameVector;
-	ColorTableVector m_colorTableVector;
-};
 class QRenderImage;
 
 
@@ -0,0 +1,57 @@
+#-------------------------------------------------
+#
+# Headless batch processing of the saved sessions
+# (no widgets: runs on a server without a display)
+#
+#-------------------------------------------------
+
+QT       += core gui
+QT       -= widgets
+
+TARGET = DoulosBatch
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+
+win32 {
+    INCLUDEPATH += $$PWD/include
+
+    LIBS += $$PWD/lib/intel64_win/ippcore.lib \
+            $$PWD/lib/intel64_win/ippi.lib \
+            $$PWD/lib/intel64_win/ipps.lib
+    debug {
+        LIBS += $$PWD/lib/intel64_win/vc14/tbb_debug.lib
+    }
+    release {
+        LIBS += $$PWD/lib/intel64_win/vc14/tbb.lib
+    }
+}
+
+unix {
+    # IPP & TBB of the oneAPI / system installation (IPPROOT from the IPP environment script)
+    INCLUDEPATH += $$(IPPROOT)/include
+    LIBS += -L$$(IPPROOT)/lib/intel64 -lippi -lipps -lippcore
+    LIBS += -ltbb -lpthread
+}
+
+
+SOURCES += DoulosBatch/DoulosBatch.cpp \
+    DoulosBatch/BatchProcess.cpp \
+    Doulos/Viewer/ColorTable.cpp \
+    Common/allocator.cpp \
+    MemoryBuffer/FlimContainer.cpp \
+    MemoryBuffer/FlimSession.cpp
+
+HEADERS += DoulosBatch/BatchProcess.h \
+    Doulos/Configuration.h \
+    Doulos/Viewer/ColorTable.h \
+    MemoryBuffer/FlimContainer.h \
+    MemoryBuffer/FlimSession.h \
+    DataAcquisition/FLImProcess/FlimFrameResult.h \
+    Common/ImageObject.h \
+    Common/allocator.h \
+    Common/medfilt.h
@@ -0,0 +1,306 @@
+#include "BatchProcess.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QRect>
+
+#include <Doulos/Configuration.h>
+
+#include <MemoryBuffer/FlimSession.h>
+
+#include <Common/ImageObject.h>
+#include <Common/medfilt.h>
+
+#include <atomic>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+
+#include <ippi.h>
+
+
+// Intensity ratios of Doulos.m (Ch1/Ch2, Ch2/Ch3, Ch1/Ch3) and their display ranges
+static const int ratio_channels[3][2] = { { 0, 1 }, { 1, 2 }, { 0, 2 } };
+static const float ratio_range[3][2] = { { 0.0f, 0.8f }, { 2.0f, 16.0f }, { 0.0f, 12.5f } };
+
+// Display ranges hard-coded in Doulos.m (flimIntensityRange & flimLifetimeRange), used with --matlab-ranges
+static const float matlab_intensity_range[3][2] = { { 0.0f, 0.3f }, { 0.0f, 0.6f }, { 0.0f, 0.1f } };
+static const float matlab_lifetime_range[3][2] = { { 1.0f, 6.5f }, { 1.0f, 6.5f }, { 1.0f, 5.5f } };
+
+// Stitched mosaics of a session
+enum mosaic { INTENSITY = 0, LIFETIME = 3, MERGED = 6, RATIO = 9, N_MOSAICS = 12 };
+
+
+// Per-worker scratch (image objects, median filter & float plane are reused across the tasks)
+struct BatchScratch
+{
+	BatchScratch(int image_size, const QVector<QRgb>& lifetime_colortable) :
+		image(image_size, image_size, lifetime_colortable),
+		lifetime(image_size, image_size, lifetime_colortable),
+		merged(image_size, image_size, lifetime_colortable),
+		filter(image_size, image_size, 3, 3),
+		plane(image_size, image_size)
+	{
+	}
+
+	ImageObject image; // intensity & ratio images (colour table set before saving)
+	ImageObject lifetime;
+	ImageObject merged;
+	medfilt filter;
+	np::FloatArray2 plane;
+};
+
+
+static QString range_text(float min, float max)
+{
+	return QString("[%1 %2]").arg(min, 2, 'f', 1).arg(max, 2, 'f', 1);
+}
+
+static bool save_image(const QImage& image, const QRect& crop, const QString& path)
+{
+	return image.copy(crop).save(path, "bmp");
+}
+
+static void place_tile(QImage& mosaic, const QImage& image, const QRect& crop, int col, int row)
+{
+	int bpp = image.depth() / 8;
+	for (int y = 0; y < crop.height(); y++)
+		memcpy(mosaic.scanLine(row * crop.height() + y) + bpp * col * crop.width(),
+			image.constScanLine(crop.y() + y) + bpp * crop.x(), bpp * crop.width());
+}
+
+static void merge_image(QImage& merged, const QImage& lifetime_rgb, const float* intensity, const Range<float>& range)
+{
+	// Lifetime colour weighted by the intensity in its range (mat2gray, rounded as uint8())
+	float scale = 1.0f / (range.max - range.min);
+	for (int y = 0; y < merged.height(); y++)
+	{
+		const uchar* src = lifetime_rgb.constScanLine(y);
+		uchar* dst = merged.scanLine(y);
+		const float* in = intensity + y * merged.width();
+		for (int x = 0; x < merged.width(); x++)
+		{
+			float w = (in[x] - range.min) * scale;
+			if (!(w > 0.0f)) w = 0.0f;
+			if (w > 1.0f) w = 1.0f;
+			for (int c = 0; c < 3; c++)
+				dst[3 * x + c] = (uchar)(src[3 * x + c] * w + 0.5f);
+		}
+	}
+}
+
+
+BatchProcess::BatchProcess(const QString& colortable_dir, const BatchOptions& _options) :
+	options(_options), ctable(colortable_dir)
+{
+	// Colour tables of Doulos.m: a map per emission channel for intensity, jet for the ratios
+	for (int i = 0; i < 3; i++)
+		intensity_ctable[i] = ColorTable::read(QString("%1/ch%2.colortable").arg(colortable_dir).arg(i + 1));
+	ratio_ctable = ctable.m_colorTableVector.at(ColorTable::jet);
+}
+
+
+bool BatchProcess::process(const QString& path, const QString& out_dir, BatchResult& result) const
+{
+	result = BatchResult();
+
+	// 1. Session & its configuration
+	FlimSession session;
+	if (!session.open(path))
+	{
+		result.error = session.errorString();
+		return false;
+	}
+
+	QFileInfo info(path);
+	Configuration config;
+	config.getConfigFile(info.absolutePath() + "/" + info.completeBaseName() + ".ini");
+	if (options.matlab_ranges)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			config.flimIntensityRange[j].min = matlab_intensity_range[j][0];
+			config.flimIntensityRange[j].max = matlab_intensity_range[j][1];
+			config.flimLifetimeRange[j].min = matlab_lifetime_range[j][0];
+			config.flimLifetimeRange[j].max = matlab_lifetime_range[j][1];
+		}
+	}
+
+	int image_size = session.imageSize();
+	if (image_size % 4 != 0)
+	{
+		result.error = "Image size must be a multiple of 4.";
+		return false;
+	}
+	if ((config.galvoFlyingBack < 0) || (config.galvoFlyingBack >= image_size)
+		|| (config.imageStichingMisSyncPos < 0) || (config.imageStichingMisSyncPos >= image_size))
+	{
+		result.error = "Invalid cropping (galvoFlyingBack or imageStichingMisSyncPos).";
+		return false;
+	}
+	if ((config.flimLifetimeColorTable < 0) || (config.flimLifetimeColorTable >= ctable.m_colorTableVector.size()))
+	{
+		result.error = "Invalid lifetime colour table.";
+		return false;
+	}
+	if (!QDir().mkpath(out_dir))
+	{
+		result.error = "Failed to create the output folder.";
+		return false;
+	}
+
+	// Flying-back columns & mis-synced rows are cropped off every image
+	QRect crop(config.galvoFlyingBack, config.imageStichingMisSyncPos,
+		image_size - config.galvoFlyingBack, image_size - config.imageStichingMisSyncPos);
+	QString dir = out_dir + "/";
+	const QVector<QRgb>& lifetime_ctable = ctable.m_colorTableVector.at(config.flimLifetimeColorTable);
+
+	// 2. Stitched mosaics (tiles in the serpentine order of the stage scan)
+	int n_frames = session.frames();
+	int x_step = session.xStep(), y_step = session.yStep();
+	bool stitch = options.stitch && (x_step * y_step > 1) && (n_frames == x_step * y_step);
+
+	QImage mosaics[N_MOSAICS];
+	if (stitch)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			mosaics[INTENSITY + j] = QImage(x_step * crop.width(), y_step * crop.height(), QImage::Format_Indexed8);
+			mosaics[INTENSITY + j].setColorTable(intensity_ctable[j]);
+			mosaics[LIFETIME + j] = QImage(x_step * crop.width(), y_step * crop.height(), QImage::Format_Indexed8);
+			mosaics[LIFETIME + j].setColorTable(lifetime_ctable);
+			mosaics[MERGED + j] = QImage(x_step * crop.width(), y_step * crop.height(), QImage::Format_RGB888);
+			mosaics[RATIO + j] = QImage(x_step * crop.width(), y_step * crop.height(), QImage::Format_Indexed8);
+			mosaics[RATIO + j].setColorTable(ratio_ctable);
+		}
+	}
+
+	// 3. Frames (channel & ratio tasks, each worker reusing its own scratch)
+	IppiSize roi_flim = { image_size, image_size };
+	tbb::enumerable_thread_specific<BatchScratch> scratches(image_size, lifetime_ctable);
+	std::atomic<int> n_images(0), n_failed(0);
+
+	for (int i = 0; i < n_frames; i++)
+	{
+		// Planes of the frame (.flim: decoded once here, then shared read-only by the tasks)
+		np::FloatArray2 intensity[3], lifetime[3];
+		for (int j = 0; j < 3; j++)
+		{
+			intensity[j] = session.intensity(i, j);
+			lifetime[j] = session.lifetime(i, j);
+		}
+
+		int n = n_frames - i; // numbered from the last frame as Doulos.m
+		int row = i / x_step;
+		int col = (row % 2) ? x_step - 1 - i % x_step : i % x_step;
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, 6, 1),
+			[&](const tbb::blocked_range<size_t>& r) {
+			BatchScratch& scratch = scratches.local();
+			for (size_t t = r.begin(); t != r.end(); ++t)
+			{
+				int j = (int)t % 3;
+				bool ok = true;
+				if (t < 3)
+				{
+					const Range<float>& irange = config.flimIntensityRange[j];
+					const Range<float>& lrange = config.flimLifetimeRange[j];
+
+					// Intensity image
+					ippiScale_32f8u_C1R(intensity[j].raw_ptr(), sizeof(float) * roi_flim.width, scratch.image.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
+						roi_flim, irange.min, irange.max);
+					scratch.image.qindeximg.setColorTable(intensity_ctable[j]);
+					ok &= save_image(scratch.image.qindeximg, crop, dir + QString("intensity_image_ch_%1_avg_%2_%3_%4.bmp")
+						.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(irange.min, irange.max)).arg(n));
+					if (stitch)
+						place_tile(mosaics[INTENSITY + j], scratch.image.qindeximg, crop, col, row);
+
+					// Lifetime image (median filtered before scaling)
+					memcpy(scratch.plane.raw_ptr(), lifetime[j].raw_ptr(), sizeof(float) * scratch.plane.length());
+					if (options.medfilt)
+						scratch.filter(scratch.plane.raw_ptr());
+					ippiScale_32f8u_C1R(scratch.plane.raw_ptr(), sizeof(float) * roi_flim.width, scratch.lifetime.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
+						roi_flim, lrange.min, lrange.max);
+					ok &= save_image(scratch.lifetime.qindeximg, crop, dir + QString("lifetime_image_ch_%1_avg_%2_%3_%4.bmp")
+						.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(lrange.min, lrange.max)).arg(n));
+					if (stitch)
+						place_tile(mosaics[LIFETIME + j], scratch.lifetime.qindeximg, crop, col, row);
+
+					// Merged image (serial conversion: no nested parallel loop while this worker holds its scratch)
+					scratch.lifetime.convertNonScaledRgb();
+					merge_image(scratch.merged.qrgbimg, scratch.lifetime.qrgbimg, intensity[j].raw_ptr(), irange);
+					ok &= save_image(scratch.merged.qrgbimg, crop, dir + QString("merged_image_ch_%1_avg_%2_i%3_l%4_%5.bmp")
+						.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(irange.min, irange.max))
+						.arg(range_text(lrange.min, lrange.max)).arg(n));
+					if (stitch)
+						place_tile(mosaics[MERGED + j], scratch.merged.qrgbimg, crop, col, row);
+
+					n_images += 3;
+				}
+				else
+				{
+					// Intensity ratio (x / 0: top of the range, 0 / 0: bottom of the range as MATLAB's Inf & NaN)
+					const float* num = intensity[ratio_channels[j][0]].raw_ptr();
+					const float* den = intensity[ratio_channels[j][1]].raw_ptr();
+					float* ratio = scratch.plane.raw_ptr();
+					for (int k = 0; k < scratch.plane.length(); k++)
+					{
+						float v = (den[k] != 0.0f) ? num[k] / den[k] : ((num[k] > 0.0f) ? ratio_range[j][1] : ratio_range[j][0]);
+						if (!(v > ratio_range[j][0])) v = ratio_range[j][0];
+						if (v > ratio_range[j][1]) v = ratio_range[j][1];
+						ratio[k] = v;
+					}
+
+					ippiScale_32f8u_C1R(ratio, sizeof(float) * roi_flim.width, scratch.image.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
+						roi_flim, ratio_range[j][0], ratio_range[j][1]);
+					scratch.image.qindeximg.setColorTable(ratio_ctable);
+					ok &= save_image(scratch.image.qindeximg, crop, dir + QString("intensity_ratio_Ch%1_Ch%2%3_%4.bmp")
+						.arg(ratio_channels[j][0] + 1).arg(ratio_channels[j][1] + 1).arg(range_text(ratio_range[j][0], ratio_range[j][1])).arg(n));
+					if (stitch)
+						place_tile(mosaics[RATIO + j], scratch.image.qindeximg, crop, col, row);
+
+					n_images++;
+				}
+
+				if (!ok)
+					n_failed++;
+			}
+		});
+	}
+
+	// 4. Stitched images
+	if (stitch)
+	{
+		QRect whole(0, 0, mosaics[0].width(), mosaics[0].height());
+		for (int j = 0; j < 3; j++)
+		{
+			const Range<float>& irange = config.flimIntensityRange[j];
+			const Range<float>& lrange = config.flimLifetimeRange[j];
+
+			bool ok = save_image(mosaics[INTENSITY + j], whole, dir + QString("stitched_intensity_image_ch_%1_avg_%2_%3.bmp")
+				.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(irange.min, irange.max)));
+			ok &= save_image(mosaics[LIFETIME + j], whole, dir + QString("stitched_lifetime_image_ch_%1_avg_%2_%3.bmp")
+				.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(lrange.min, lrange.max)));
+			ok &= save_image(mosaics[MERGED + j], whole, dir + QString("stitched_merged_image_ch_%1_avg_%2_i%3_l%4.bmp")
+				.arg(j + 1).arg(config.imageAveragingFrames).arg(range_text(irange.min, irange.max)).arg(range_text(lrange.min, lrange.max)));
+			ok &= save_image(mosaics[RATIO + j], whole, dir + QString("stitched_intensity_ratio_Ch%1_Ch%2%3.bmp")
+				.arg(ratio_channels[j][0] + 1).arg(ratio_channels[j][1] + 1).arg(range_text(ratio_range[j][0], ratio_range[j][1])));
+			n_images += 4;
+
+			if (!ok)
+				n_failed++;
+		}
+	}
+
+	result.frames = n_frames;
+	result.images = n_images;
+	if (n_failed > 0)
+	{
+		result.error = "Error occurred while writing the images...";
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,50 @@
+#ifndef BATCH_PROCESS_H
+#define BATCH_PROCESS_H
+
+#include <QString>
+#include <QVector>
+#include <QRgb>
+
+#include <Doulos/Viewer/ColorTable.h>
+
+
+struct BatchOptions
+{
+	QString output = "scaled_image_matlab"; // folder of the images (next to the session)
+	bool medfilt = true; // 3 x 3 median filter of the lifetime maps
+	bool stitch = true; // stitched mosaics of the tiled sessions
+	bool matlab_ranges = false; // display ranges hard-coded in Doulos.m instead of the ones of the session's .ini
+};
+
+struct BatchResult
+{
+	int frames = 0;
+	int images = 0; // bmp files written
+	QString error;
+};
+
+
+// Offline processing of a saved session (.data / .flim with its side-car .ini), as Doulos.m does:
+// scaled intensity, lifetime & merged images, intensity ratios and (for the tiled sessions) stitched mosaics.
+// The frames of a session are processed in order; the channels & ratios of a frame run as parallel tasks.
+// process() only reads the shared colour tables, so that the sessions can be processed concurrently.
+class BatchProcess
+{
+public:
+	explicit BatchProcess(const QString& colortable_dir, const BatchOptions& options);
+
+private: // Not to call copy constrcutor and copy assignment operator
+	BatchProcess(const BatchProcess&);
+	BatchProcess& operator=(const BatchProcess&);
+
+public:
+	bool process(const QString& path, const QString& out_dir, BatchResult& result) const;
+
+private:
+	BatchOptions options;
+	ColorTable ctable; // lifetime colour table by flimLifetimeColorTable
+	QVector<QRgb> intensity_ctable[3]; // emission channels
+	QVector<QRgb> ratio_ctable;
+};
+
+#endif // BATCH_PROCESS_H
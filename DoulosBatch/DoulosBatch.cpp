@@ -0,0 +1,171 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMap>
+
+#include <Doulos/Configuration.h>
+
+#include "BatchProcess.h"
+
+#include <cstdio>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+
+#include <tbb/task_arena.h>
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+
+// Headless reprocessing of the saved sessions (Doulos.m without MATLAB)
+// usage: DoulosBatch [options] <sessions or directories...>
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QCoreApplication::setApplicationName("DoulosBatch");
+	QCoreApplication::setApplicationVersion(VERSION);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Batch processing of the saved Doulos sessions (.data / .flim with the side-car .ini):\n"
+		"scaled intensity, lifetime & merged images, intensity ratios and stitched mosaics as Doulos.m.");
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("paths", "Session files, or directories searched recursively for sessions.", "<paths...>");
+
+	QCommandLineOption colortableOption(QStringList() << "c" << "colortable", "Folder of the colour tables.", "dir",
+		QDir(QCoreApplication::applicationDirPath()).filePath("ColorTable"));
+	QCommandLineOption outputOption(QStringList() << "o" << "output", "Image folder created next to each session.", "name", BatchOptions().output);
+	QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "Worker threads (0: all cores).", "n", "0");
+	QCommandLineOption noMedfiltOption("no-medfilt", "Lifetime maps without the 3 x 3 median filter.");
+	QCommandLineOption noStitchOption("no-stitch", "No stitched mosaics for the tiled sessions.");
+	QCommandLineOption matlabRangesOption("matlab-ranges", "Display ranges hard-coded in Doulos.m instead of the ones of each session's .ini.");
+	QCommandLineOption overwriteOption("overwrite", "Process the sessions whose image folder already exists.");
+	parser.addOption(colortableOption);
+	parser.addOption(outputOption);
+	parser.addOption(jobsOption);
+	parser.addOption(noMedfiltOption);
+	parser.addOption(noStitchOption);
+	parser.addOption(matlabRangesOption);
+	parser.addOption(overwriteOption);
+	parser.process(a);
+
+	if (parser.positionalArguments().isEmpty())
+		parser.showHelp(1);
+
+	// 1. Options & colour tables
+	BatchOptions options;
+	options.output = parser.value(outputOption);
+	options.medfilt = !parser.isSet(noMedfiltOption);
+	options.stitch = !parser.isSet(noStitchOption);
+	options.matlab_ranges = parser.isSet(matlabRangesOption);
+
+	QString colortable_dir = parser.value(colortableOption);
+	if (!QFileInfo::exists(colortable_dir + "/jet.colortable"))
+	{
+		if (!parser.isSet(colortableOption) && QFileInfo::exists("ColorTable/jet.colortable"))
+			colortable_dir = "ColorTable";
+		else
+		{
+			fprintf(stderr, "Colour tables are not found in %s.\n", colortable_dir.toLocal8Bit().constData());
+			return 1;
+		}
+	}
+	BatchProcess batch(colortable_dir, options);
+
+	// 2. Sessions (recorded data with its configuration)
+	QStringList sessions;
+	QStringList filters = QStringList() << "*.data" << "*.flim";
+	for (const QString& arg : parser.positionalArguments())
+	{
+		QFileInfo info(arg);
+		if (info.isDir())
+		{
+			QDirIterator it(arg, filters, QDir::Files, QDirIterator::Subdirectories);
+			while (it.hasNext())
+				sessions << QFileInfo(it.next()).absoluteFilePath();
+		}
+		else if (info.isFile())
+			sessions << info.absoluteFilePath();
+		else
+			fprintf(stderr, "%s is not found.\n", arg.toLocal8Bit().constData());
+	}
+
+	sessions.removeDuplicates();
+
+	QStringList valid;
+	QMap<QString, int> per_dir;
+	for (const QString& path : sessions)
+	{
+		QFileInfo info(path);
+		if (QFileInfo::exists(info.absolutePath() + "/" + info.completeBaseName() + ".ini"))
+		{
+			valid << path;
+			per_dir[info.absolutePath()]++;
+		}
+		else
+			fprintf(stderr, "%s is skipped (no configuration .ini).\n", path.toLocal8Bit().constData());
+	}
+
+	// Images next to the session as Doulos.m (in a sub-folder per session when a folder holds several)
+	QStringList out_dirs;
+	for (const QString& path : valid)
+	{
+		QFileInfo info(path);
+		QString out_dir = info.absolutePath() + "/" + options.output;
+		if (per_dir[info.absolutePath()] > 1)
+			out_dir += "/" + info.completeBaseName();
+		out_dirs << out_dir;
+	}
+
+	// 3. Sessions in parallel (one session per worker, the tasks of a session fill the idle workers)
+	int jobs = parser.value(jobsOption).toInt();
+	bool overwrite = parser.isSet(overwriteOption);
+	tbb::task_arena arena(jobs > 0 ? jobs : tbb::task_arena::automatic);
+
+	std::mutex mtx_print;
+	std::atomic<int> n_done(0), n_skipped(0), n_failed(0);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	printf("%d sessions to process.\n", valid.size());
+	arena.execute([&]() {
+		tbb::parallel_for(tbb::blocked_range<int>(0, valid.size(), 1),
+			[&](const tbb::blocked_range<int>& r) {
+			for (int i = r.begin(); i != r.end(); ++i)
+			{
+				QByteArray name = valid.at(i).toLocal8Bit();
+				if (!overwrite && QFileInfo::exists(out_dirs.at(i)))
+				{
+					std::unique_lock<std::mutex> lock(mtx_print);
+					printf("[%s] skipped (images exist, --overwrite to reprocess)\n", name.constData());
+					n_skipped++;
+					continue;
+				}
+
+				std::chrono::steady_clock::time_point tick = std::chrono::steady_clock::now();
+				BatchResult result;
+				bool ok = batch.process(valid.at(i), out_dirs.at(i), result);
+				std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - tick;
+
+				std::unique_lock<std::mutex> lock(mtx_print);
+				if (ok)
+				{
+					printf("[%s] %d frames, %d images (%.1f sec)\n", name.constData(), result.frames, result.images, elapsed.count());
+					n_done++;
+				}
+				else
+				{
+					printf("[%s] failed: %s\n", name.constData(), result.error.toLocal8Bit().constData());
+					n_failed++;
+				}
+				fflush(stdout);
+			}
+		});
+	});
+
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	printf("%d processed, %d skipped, %d failed (%.1f sec)\n", n_done.load(), n_skipped.load(), n_failed.load(), elapsed.count());
+
+	return (n_failed > 0) ? 1 : 0;
+}
@@ -0,0 +1,70 @@
+#-------------------------------------------------
+#
+# Benchmarks & regression checks of the processing
+# pipeline on the frames of the DAQ simulator
+# (no digitizer, no display)
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui widgets
+
+TARGET = DoulosBench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+
+win32 {
+    INCLUDEPATH += $$PWD/include
+
+    LIBS += $$PWD/lib/intel64_win/ippcore.lib \
+            $$PWD/lib/intel64_win/ippi.lib \
+            $$PWD/lib/intel64_win/ipps.lib
+    debug {
+        LIBS += $$PWD/lib/intel64_win/vc14/tbb_debug.lib
+    }
+    release {
+        LIBS += $$PWD/lib/intel64_win/vc14/tbb.lib
+    }
+    LIBS += $$PWD/lib/intel64_win/mkl_core.lib \
+            $$PWD/lib/intel64_win/mkl_tbb_thread.lib \
+            $$PWD/lib/intel64_win/mkl_intel_lp64.lib
+}
+
+unix {
+    # IPP, MKL & TBB of the oneAPI / system installation (IPPROOT & MKLROOT from the environment scripts)
+    INCLUDEPATH += $$(IPPROOT)/include $$(MKLROOT)/include
+    LIBS += -L$$(IPPROOT)/lib/intel64 -lippi -lipps -lippcore
+    LIBS += -L$$(MKLROOT)/lib/intel64 -lmkl_intel_lp64 -lmkl_tbb_thread -lmkl_core
+    LIBS += -ltbb -lpthread
+}
+
+
+SOURCES += DoulosBench/DoulosBench.cpp \
+    DoulosBench/BenchFlim.cpp \
+    DoulosBench/BenchJitter.cpp \
+    DoulosBench/BenchWidth.cpp \
+    DoulosBench/BenchRing.cpp \
+    DoulosBench/BenchPipeline.cpp \
+    Common/allocator.cpp \
+    DataAcquisition/ThreadManager.cpp \
+    DataAcquisition/SimulatorDAQ/SimulatorDAQ.cpp \
+    DataAcquisition/FLImProcess/FLImProcess.cpp
+
+HEADERS += DoulosBench/Bench.h \
+    Doulos/Configuration.h \
+    Common/array.h \
+    Common/allocator.h \
+    Common/callback.h \
+    Common/SyncRing.h \
+    Common/SyncObject.h \
+    Common/Queue.h \
+    DataAcquisition/DaqInterface.h \
+    DataAcquisition/ThreadManager.h \
+    DataAcquisition/SimulatorDAQ/SimulatorDAQ.h \
+    DataAcquisition/FLImProcess/FLImProcess.h \
+    DataAcquisition/FLImProcess/FlimFrameResult.h
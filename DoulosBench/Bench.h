@@ -0,0 +1,40 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Doulos/Configuration.h>
+
+#include <DataAcquisition/FLImProcess/FLImProcess.h>
+
+#include <vector>
+#include <chrono>
+
+
+struct BenchOptions
+{
+	int frames = 50; // timed frames (per case)
+	int mode = -1; // FLIm up-sampling mode (-1: every mode)
+	float jitter = 0.5f; // simulated trigger jitter (peak-to-peak) [samples]
+	double rate = -1.0; // hand-off rate [fps] (0: unthrottled, -1: 1000, 2000, 5000 fps & unthrottled; pipeline: <= 0 free-running)
+};
+
+
+// Synthetic frames of the DAQ simulator (FLIM_SCANS x FLIM_ALINES) and the FLIm parameters of its pulses
+bool simulateFrames(int n_frames, float jitter, std::vector<Uint16Array2>& frames, FLIM_PARAMS& params);
+
+// Largest lifetime difference over the A-lines & channels valid in both results [nsec] (n_mismatch: valid in one only)
+float maxLifetimeDiff(const FloatArray2& a, const FloatArray2& b, int& n_mismatch);
+
+inline double elapsedMs(std::chrono::steady_clock::time_point tick)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tick).count();
+}
+
+
+// Sub-commands (0: passed)
+int benchFlim(const BenchOptions& options); // FLIm processing rate of each up-sampling mode
+int benchJitter(const BenchOptions& options); // jitter compensation against the rotate version
+int benchWidth(const BenchOptions& options); // batched width search against the A-line routine
+int benchRing(const BenchOptions& options); // buffer hand-off latency & throughput of SyncRing
+int benchPipeline(const BenchOptions& options); // streaming pipeline of QStreamTab without the widgets
+
+#endif // BENCH_H
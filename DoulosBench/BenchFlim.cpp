@@ -0,0 +1,132 @@
+#include "Bench.h"
+
+#include <DataAcquisition/SimulatorDAQ/SimulatorDAQ.h>
+
+#include <cstdio>
+#include <cmath>
+#include <mutex>
+#include <condition_variable>
+
+
+bool simulateFrames(int n_frames, float jitter, std::vector<Uint16Array2>& frames, FLIM_PARAMS& params)
+{
+	SimulatorDAQ sim;
+	sim.nScans = FLIM_SCANS;
+	sim.nAlines = FLIM_ALINES;
+	sim.Jitter = jitter;
+	sim.DaqRate = 0.0; // free-running
+
+	std::mutex mtx;
+	std::condition_variable cond;
+	frames.clear();
+	frames.reserve(n_frames);
+
+	sim.SendStatusMessage += [&](const char* msg, bool is_error) { if (is_error) fprintf(stderr, "%s\n", msg); };
+	sim.DidAcquireData += [&](int frame_count, const np::Uint16Array2& frame) {
+		(void)frame_count;
+		std::unique_lock<std::mutex> lock(mtx);
+		if ((int)frames.size() < n_frames)
+		{
+			frames.push_back(Uint16Array2(frame.size(0), frame.size(1)));
+			memcpy(frames.back().raw_ptr(), frame.raw_ptr(), sizeof(uint16_t) * frame.length());
+			if ((int)frames.size() == n_frames)
+				cond.notify_one();
+		}
+	};
+	sim.DidStopData += [&]() { sim._running = false; };
+
+	if (!sim.set_init() || !sim.startAcquisition())
+		return false;
+	{
+		std::unique_lock<std::mutex> lock(mtx);
+		cond.wait(lock, [&]() { return (int)frames.size() == n_frames; });
+	}
+	sim.stopAcquisition();
+
+	// Processing parameters of the simulated pulses
+	params = FLIM_PARAMS();
+	params.bg = sim.Bg;
+	params.samp_intv = sim.SampIntv;
+	params.n_ch = sim.nCh;
+	for (int i = 0; i < 4; i++)
+		params.ch_start_ind[i] = sim.ChStartInd[i];
+	params.ch_start_ind[4] = sim.ChStartInd[3] + FLIM_CH_START_5;
+	for (int i = 0; i < 3; i++)
+		params.delay_offset[i] = sim.DelayOffset[i];
+
+	return true;
+}
+
+float maxLifetimeDiff(const FloatArray2& a, const FloatArray2& b, int& n_mismatch)
+{
+	float max_diff = 0.0f;
+	n_mismatch = 0;
+	for (int i = 0; i < a.length(); i++)
+	{
+		bool valid_a = (a(i) > 0.0f), valid_b = (b(i) > 0.0f);
+		if (valid_a && valid_b)
+			max_diff = std::max(max_diff, fabsf(a(i) - b(i)));
+		else if (valid_a != valid_b)
+			n_mismatch++;
+	}
+	return max_diff;
+}
+
+
+// FLIm processing rate of each up-sampling mode on the same simulated frames, with the lifetime agreement to the MKL spline mode
+int benchFlim(const BenchOptions& options)
+{
+	static const char* mode_names[] = { "MKL spline", "spline matrix", "fused", "fused ROI" };
+
+	// 1. Simulated frames
+	std::vector<Uint16Array2> frames;
+	FLIM_PARAMS params;
+	if (!simulateFrames(8, options.jitter, frames, params))
+		return 1;
+
+	int alines = frames.front().size(1);
+	printf("FLIm processing: %d x %d frames, %d timed per mode\n", frames.front().size(0), alines, options.frames);
+
+	// 2. Each mode on the same frames (the first call initializes the objects & is not timed)
+	FloatArray2 ref_lifetime;
+	for (int mode = UPSAMPLE_MKL_SPLINE; mode <= UPSAMPLE_FUSED_ROI; mode++)
+	{
+		bool timed = (options.mode < 0) || (mode == options.mode);
+		if (!timed && (mode != UPSAMPLE_MKL_SPLINE)) // the MKL spline mode is always run as the reference
+			continue;
+
+		FLImProcess flim;
+		flim._params = params;
+		flim._params.upsample_mode = mode;
+
+		FloatArray2 intensity(alines, 4), mean_delay(alines, 4), lifetime(alines, 3);
+		flim(intensity, mean_delay, lifetime, frames.front());
+
+		if (mode == UPSAMPLE_MKL_SPLINE)
+		{
+			ref_lifetime = FloatArray2(alines, 3);
+			memcpy(ref_lifetime.raw_ptr(), lifetime.raw_ptr(), sizeof(float) * lifetime.length());
+		}
+		if (!timed)
+			continue;
+
+		std::chrono::steady_clock::time_point tick = std::chrono::steady_clock::now();
+		for (int i = 0; i < options.frames; i++)
+			flim(intensity, mean_delay, lifetime, frames.at(i % frames.size()));
+		double ms = elapsedMs(tick) / options.frames;
+
+		printf("  %-14s %8.2f ms/frame %8.1f fps", mode_names[mode], ms, 1000.0 / ms);
+		if (mode != UPSAMPLE_MKL_SPLINE)
+		{
+			// Lifetimes of the first frame against the MKL spline mode
+			flim(intensity, mean_delay, lifetime, frames.front());
+			int n_mismatch;
+			float max_diff = maxLifetimeDiff(ref_lifetime, lifetime, n_mismatch);
+			printf("   max |d lifetime| %.4f nsec (%d A-line channels valid in one mode only)", max_diff, n_mismatch);
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+
+// Jitter compensation of the rotate version (before the per A-line views): the cropped window of each A-line
+// rotated in place so that its IRF peak sits at the reference position (the last sample is left out of the rotation)
+static void rotateJitter(Uint16Array2& frame, const FLIM_PARAMS& params, int ref_pos)
+{
+	int scans = frame.size(0);
+	int nx = params.ch_end_ind() - params.ch_start_ind[0];
+	int irf_wlen = params.ch_start_ind[1] - params.ch_start_ind[0];
+
+	for (int i = 0; i < frame.size(1); i++)
+	{
+		uint16_t* window = frame.raw_ptr() + i * scans + params.ch_start_ind[0];
+		int cpos = (int)(std::max_element(window, window + irf_wlen) - window);
+
+		int offset = cpos - ref_pos;
+		if (offset < 0) offset += nx;
+		std::rotate(window, window + offset, window + nx - 1);
+	}
+}
+
+
+// Lifetimes of the view-based jitter compensation against the rotate version, on the same simulated frames
+// (the rotated frames are already aligned, so the views are not shifted and the rest of the processing is shared)
+int benchJitter(const BenchOptions& options)
+{
+	static const char* mode_names[] = { "MKL spline", "spline matrix", "fused", "fused ROI" };
+	const float tolerance = 1e-3f; // [nsec] for the A-lines shifted forward (no wrap-around in the rotate version)
+
+	// 1. Simulated frames
+	std::vector<Uint16Array2> frames;
+	FLIM_PARAMS params;
+	int n_frames = std::max(1, std::min(options.frames, 16));
+	if (!simulateFrames(n_frames, options.jitter, frames, params))
+		return 1;
+
+	int alines = frames.front().size(1);
+	printf("Jitter compensation: %d frames of %d x %d, %.1f samples jitter (peak-to-peak), views against the rotate version\n",
+		n_frames, frames.front().size(0), alines, options.jitter);
+
+	// 2. Each mode: the frames as acquired and rotated
+	bool passed = true;
+	for (int mode = UPSAMPLE_MKL_SPLINE; mode <= UPSAMPLE_FUSED_ROI; mode++)
+	{
+		if ((options.mode >= 0) && (mode != options.mode))
+			continue;
+
+		FLImProcess flim, flim_rotate;
+		flim._params = params;
+		flim._params.upsample_mode = mode;
+		flim_rotate._params = flim._params;
+
+		FloatArray2 intensity(alines, 4), mean_delay(alines, 4), lifetime(alines, 3);
+		FloatArray2 intensity_r(alines, 4), mean_delay_r(alines, 4), lifetime_r(alines, 3);
+
+		int n_shift[3] = { 0, }; // backward, none, forward
+		float max_diff[2] = { 0.0f, 0.0f }; // backward, none or forward
+		int n_mismatch = 0;
+		for (int f = 0; f < n_frames; f++)
+		{
+			flim(intensity, mean_delay, lifetime, frames.at(f));
+
+			Uint16Array2 rotated(frames.at(f).size(0), alines);
+			memcpy(rotated.raw_ptr(), frames.at(f).raw_ptr(), sizeof(uint16_t) * rotated.length());
+			rotateJitter(rotated, params, flim._resize.ref_pos);
+			flim_rotate(intensity_r, mean_delay_r, lifetime_r, rotated);
+
+			for (int i = 0; i < alines; i++)
+			{
+				int shift = flim._resize.pShift[i] - flim._resize.jitter_pre;
+				int k = (shift < 0) ? 0 : 1;
+				n_shift[(shift > 0) ? 2 : k]++;
+
+				for (int j = 0; j < 3; j++)
+				{
+					bool valid = (lifetime(i, j) > 0.0f), valid_r = (lifetime_r(i, j) > 0.0f);
+					if (valid && valid_r)
+						max_diff[k] = std::max(max_diff[k], fabsf(lifetime(i, j) - lifetime_r(i, j)));
+					else if ((valid != valid_r) && (k == 1))
+						n_mismatch++;
+				}
+			}
+		}
+
+		bool ok = (max_diff[1] <= tolerance) && (n_mismatch == 0);
+		passed &= ok;
+		printf("  %-14s shift >= 0: %6d A-lines, max |d lifetime| %.5f nsec (%d valid in one version only)   shift < 0: %6d A-lines, max |d lifetime| %.4f nsec   %s\n",
+			mode_names[mode], n_shift[1] + n_shift[2], max_diff[1], n_mismatch, n_shift[0], max_diff[0], ok ? "ok" : "FAILED");
+		fflush(stdout);
+	}
+
+	printf("The rotate version aligns the IRF peak of the A-lines shifted backward one sample early (wrap-around of the window),\n"
+		"so only the A-lines shifted forward are held to %.0e nsec.\n", tolerance);
+
+	return passed ? 0 : 1;
+}
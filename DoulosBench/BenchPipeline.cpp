@@ -0,0 +1,243 @@
+#include "Bench.h"
+
+#include <DataAcquisition/SimulatorDAQ/SimulatorDAQ.h>
+#include <DataAcquisition/ThreadManager.h>
+#include <Common/SyncRing.h>
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#define PIPELINE_BENCH_IMAGE_SIZE	128 // visualization image (imageSize of Doulos.ini)
+
+
+// Streaming pipeline of QStreamTab without the widgets: SimulatorDAQ -> frames dealt in turn to the processing workers
+// (passed to the next worker when one is full, drop-newest back-pressure when all are) -> FLImProcess of each worker -> results reassembled in order (SyncReorder) & averaged into
+// the visualization images. Stopped as QOperationTab does: acquisition, processing rings, workers, visualization.
+int benchPipeline(const BenchOptions& options)
+{
+	const int n_worker = FLIM_PROCESSING_WORKERS;
+	const int image_size = PIPELINE_BENCH_IMAGE_SIZE;
+
+	// 1. Acquisition (the frame rate is turned into the sample rate of the simulator)
+	SimulatorDAQ sim;
+	sim.nScans = FLIM_SCANS;
+	sim.nAlines = FLIM_ALINES;
+	sim.Jitter = options.jitter;
+	sim.DaqRate = (options.rate > 0) ? options.rate * FLIM_SCANS * FLIM_ALINES / 1e6 : 0.0;
+	sim.SendStatusMessage += [&](const char* msg, bool is_error) { if (is_error) fprintf(stderr, "%s\n", msg); };
+	sim.DidStopData += [&]() { sim._running = false; };
+	if (!sim.set_init())
+		return 1;
+
+	FLIM_PARAMS params;
+	params.bg = sim.Bg;
+	params.samp_intv = sim.SampIntv;
+	params.n_ch = sim.nCh;
+	for (int i = 0; i < 4; i++)
+		params.ch_start_ind[i] = sim.ChStartInd[i];
+	params.ch_start_ind[4] = sim.ChStartInd[3] + FLIM_CH_START_5;
+	for (int i = 0; i < 3; i++)
+		params.delay_offset[i] = sim.DelayOffset[i];
+	params.upsample_mode = (options.mode >= 0) ? options.mode : UPSAMPLE_MKL_SPLINE;
+
+	// 2. Threading buffers & processing objects
+	SyncRing<FlimPulseFrame> sync_processing[n_worker];
+	SyncRing<FlimFrameResult> sync_visualization[n_worker];
+	SyncReorder<FlimFrameResult, n_worker> reorder(sync_visualization);
+	FLImProcess flim[n_worker];
+	ThreadManager* thread_process[n_worker];
+	ThreadManager thread_visualization("Visualization process");
+
+	int numa_nodes = np::frame_allocator::numa_nodes();
+	for (int k = 0; k < n_worker; k++)
+	{
+		if (numa_nodes > 1)
+			sync_processing[k].numa_node = k % numa_nodes;
+		sync_processing[k].allocate_queue_object(PROCESSING_BUFFER_SIZE / n_worker, FLIM_SCANS, FLIM_ALINES);
+		sync_visualization[k].allocate_queue_object(PROCESSING_BUFFER_SIZE / n_worker, FLIM_ALINES);
+		flim[k]._params = params;
+
+		char name[256];
+		sprintf(name, "FLIm image process #%d", k);
+		thread_process[k] = new ThreadManager(name);
+	}
+
+	// 3. Acquisition callback (frame accounting of QStreamTab)
+	std::chrono::steady_clock::time_point tick_start = std::chrono::steady_clock::now();
+	int n_frames = options.frames;
+	int dropped = 0, frame_seq = 0, skipped = 0;
+	std::atomic<int> acquired(0), processed(0), dropped_processing(0);
+
+	sim.DidAcquireData += [&](int frame_count, const np::Uint16Array2& frame) {
+		if (frame_count >= n_frames)
+			return;
+		if (frame_count == 0)
+			tick_start = std::chrono::steady_clock::now();
+		acquired++;
+
+		FlimPulseFrame* pulse_ptr = nullptr;
+		int skip = 0;
+		for (; skip < n_worker; skip++)
+			if ((pulse_ptr = sync_processing[(frame_seq + skip) % n_worker].get_buffer()) != nullptr)
+				break;
+		if (pulse_ptr != nullptr)
+		{
+			memcpy(pulse_ptr->pulse.raw_ptr(), frame.raw_ptr(), sizeof(uint16_t) * pulse_ptr->pulse.length());
+			frame_seq += skip;
+			skipped += skip;
+			pulse_ptr->frame_index = frame_seq++;
+			pulse_ptr->timestamp = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start).count();
+			sync_processing[pulse_ptr->frame_index % n_worker].push(pulse_ptr);
+		}
+		else
+			dropped++;
+	};
+
+	// 4. Processing workers
+	for (int k = 0; k < n_worker; k++)
+	{
+		thread_process[k]->DidAcquireData += [&, k](int frame_count) {
+			if (frame_count == 0)
+				sync_processing[k].bind_consumer();
+
+			FlimPulseFrame* pulse_data = sync_processing[k].pop();
+			if (pulse_data != nullptr)
+			{
+				FlimFrameResult* flim_ptr = sync_visualization[k].get_buffer();
+				if (flim_ptr != nullptr)
+				{
+					flim_ptr->frame_index = pulse_data->frame_index;
+					flim_ptr->timestamp = pulse_data->timestamp;
+					flim[k](*flim_ptr, pulse_data->pulse);
+
+					sync_visualization[k].push(flim_ptr);
+					processed++;
+				}
+				else
+					dropped_processing++;
+				sync_processing[k].return_buffer(pulse_data);
+			}
+			else
+			{
+				sync_visualization[k].stop();
+				thread_process[k]->_running = false;
+			}
+		};
+	}
+
+	// 5. Visualization: frame order, end-to-end latency & averaged images
+	np::FloatArray2 temp_intensity(image_size, 3 * image_size), temp_lifetime(image_size, 3 * image_size), non_nan(image_size, 3 * image_size);
+	np::FloatArray2 vis_intensity(image_size, 3 * image_size), vis_lifetime(image_size, 3 * image_size);
+	int written = 0, shown = 0, out_of_order = 0, last_index = -1, images = 0;
+	std::vector<double> latency;
+	latency.reserve(n_frames);
+
+	thread_visualization.DidAcquireData += [&](int frame_count) {
+		if (frame_count == 0)
+			reorder.reset();
+
+		int worker = 0;
+		FlimFrameResult* flim_data = reorder.pop(worker);
+		if (flim_data == nullptr)
+		{
+			thread_visualization._running = false;
+			return;
+		}
+
+		int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start).count();
+		latency.push_back(1e-3 * (double)(now - flim_data->timestamp));
+		if (flim_data->frame_index <= last_index)
+			out_of_order++;
+		last_index = flim_data->frame_index;
+		shown++;
+
+		// Averaging as QStreamTab (A-lines of the frames filling the image in turn)
+		if (written == 0)
+		{
+			memset(temp_intensity.raw_ptr(), 0, sizeof(float) * temp_intensity.length());
+			memset(temp_lifetime.raw_ptr(), 0, sizeof(float) * temp_lifetime.length());
+			memset(non_nan.raw_ptr(), 0, sizeof(float) * non_nan.length());
+		}
+		int n = std::min(flim_data->alines, image_size * image_size - written);
+		for (int i = 0; i < 3; i++)
+		{
+			const float* intensity = flim_data->intensity(i + 1);
+			ippsAdd_32f_I(intensity, &temp_intensity(0, i * image_size) + written, n);
+			ippsAdd_32f_I(flim_data->lifetime(i), &temp_lifetime(0, i * image_size) + written, n);
+			for (int j = 0; j < n; j++)
+				if (intensity[j] != 0.0f)
+					(*(&non_nan(0, i * image_size) + written + j))++;
+		}
+		written += n;
+		for (int i = 0; i < 3; i++)
+		{
+			ippsDiv_32f(&non_nan(0, i * image_size), &temp_intensity(0, i * image_size), &vis_intensity(0, i * image_size), written);
+			ippsDiv_32f(&non_nan(0, i * image_size), &temp_lifetime(0, i * image_size), &vis_lifetime(0, i * image_size), written);
+		}
+		if (written == image_size * image_size)
+		{
+			written = 0;
+			images++;
+		}
+
+		sync_visualization[worker].return_buffer(flim_data);
+	};
+
+	// 6. Run until the frames are acquired, then stop in the order of QOperationTab
+	char pace[32];
+	if (options.rate > 0) sprintf(pace, "%.0f fps", options.rate);
+	else sprintf(pace, "free-running");
+	printf("Pipeline: %d frames of %d x %d, %s, %d workers, %s mode, %d x %d images\n", n_frames, FLIM_SCANS, FLIM_ALINES, pace, n_worker,
+		(params.upsample_mode == UPSAMPLE_FUSED_ROI) ? "fused ROI" : (params.upsample_mode == UPSAMPLE_FUSED) ? "fused" :
+		(params.upsample_mode == UPSAMPLE_SPLINE_MATRIX) ? "spline matrix" : "MKL spline", image_size, image_size);
+	fflush(stdout);
+
+	thread_visualization.startThreading();
+	for (int k = 0; k < n_worker; k++)
+		thread_process[k]->startThreading();
+	bool started = sim.startAcquisition();
+	if (started)
+	{
+		while (acquired < n_frames)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		sim.stopAcquisition();
+	}
+	for (int k = 0; k < n_worker; k++)
+		sync_processing[k].stop();
+	for (int k = 0; k < n_worker; k++)
+		thread_process[k]->stopThreading();
+	thread_visualization.stopThreading();
+	if (!started)
+	{
+		for (int k = 0; k < n_worker; k++)
+			delete thread_process[k];
+		return 1;
+	}
+	double elapsed = 1e-6 * std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tick_start).count();
+
+	// 7. Frame accounting: every processed frame shown in order, every buffer back in its ring
+	int in_use = 0, high_water = 0, capacity = 0;
+	for (int k = 0; k < n_worker; k++)
+	{
+		in_use += sync_processing[k].in_use() + sync_visualization[k].in_use();
+		high_water += sync_processing[k].high_water;
+		capacity += sync_processing[k].capacity();
+		delete thread_process[k];
+	}
+
+	std::sort(latency.begin(), latency.end());
+	auto pct = [&](double p) { return latency.empty() ? 0.0 : latency.at(std::min(latency.size() - 1, (size_t)(p * latency.size()))); };
+
+	printf("  %d acquired, %d processed, %d dropped, %d dropped in processing, %d shown (%d images) in %.2f sec: %.1f fps shown\n",
+		acquired.load(), processed.load(), dropped, dropped_processing.load(), shown, images, elapsed, shown / elapsed);
+	printf("  acquisition-to-visualization latency: median %.1f ms, p99 %.1f ms, max %.1f ms / queue high-water %d of %d\n",
+		pct(0.5), pct(0.99), latency.empty() ? 0.0 : latency.back(), high_water, capacity);
+
+	bool ok = (out_of_order == 0) && (in_use == 0) && (shown == processed.load()) && (acquired == processed + dropped + dropped_processing);
+	printf("  %d sequence numbers passed over to the next worker, %d out of order, %d buffers not returned: %s\n", skipped, out_of_order, in_use, ok ? "ok" : "FAILED");
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+#include "Bench.h"
+
+#include <Common/SyncObject.h>
+#include <Common/SyncRing.h>
+
+#include <cstdio>
+#include <thread>
+#include <algorithm>
+
+#define RING_BENCH_BUFFERS			(PROCESSING_BUFFER_SIZE / 2) // buffers of one worker's ring in the pipeline
+#define RING_BENCH_HANDOFFS			40 // hand-offs per case, per --frames
+
+
+typedef long long stamp_t; // steady_clock ticks when the producer pushed the buffer
+
+struct RingStats
+{
+	std::vector<double> latency; // [usec]
+	int dropped = 0; // no free buffer for the producer
+	double elapsed = 0.0; // [sec] from the first push to the last pop
+};
+
+static stamp_t now()
+{
+	return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+static double toUsec(stamp_t ticks)
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::duration(ticks)).count();
+}
+
+
+// Producer paced at 'rate' (0: as fast as the free buffers allow) & consumer recording the push-to-pop latency
+static void runRing(SyncRing<stamp_t>& ring, int n, double rate, RingStats& stats)
+{
+	ring.reset();
+	stats.latency.reserve(n);
+
+	std::thread consumer([&]() {
+		stamp_t* buffer;
+		while ((buffer = ring.pop()) != nullptr)
+		{
+			stats.latency.push_back(toUsec(now() - *buffer));
+			ring.return_buffer(buffer);
+		}
+	});
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+	{
+		if (rate > 0)
+			std::this_thread::sleep_until(start + std::chrono::microseconds((long long)(1e6 * i / rate)));
+
+		stamp_t* buffer = (rate > 0) ? ring.get_buffer() : ring.wait_buffer(1000);
+		if (!buffer)
+		{
+			stats.dropped++;
+			continue;
+		}
+		*buffer = now();
+		ring.push(buffer);
+	}
+	ring.stop();
+	consumer.join();
+
+	stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// The same with SyncObject (free buffers under its mutex, filled buffers through its condition-variable queue)
+static void runQueue(SyncObject<stamp_t>& sync, int n, double rate, RingStats& stats)
+{
+	stats.latency.reserve(n);
+
+	std::thread consumer([&]() {
+		stamp_t* buffer;
+		while ((buffer = sync.Queue_sync.pop()) != nullptr)
+		{
+			stats.latency.push_back(toUsec(now() - *buffer));
+			std::unique_lock<std::mutex> lock(sync.mtx);
+			sync.queue_buffer.push(buffer);
+		}
+	});
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < n; i++)
+	{
+		if (rate > 0)
+			std::this_thread::sleep_until(start + std::chrono::microseconds((long long)(1e6 * i / rate)));
+
+		stamp_t* buffer = nullptr;
+		do
+		{
+			{
+				std::unique_lock<std::mutex> lock(sync.mtx);
+				if (!sync.queue_buffer.empty())
+				{
+					buffer = sync.queue_buffer.front();
+					sync.queue_buffer.pop();
+				}
+			}
+			if (!buffer && (rate == 0))
+				std::this_thread::yield();
+		} while (!buffer && (rate == 0));
+
+		if (!buffer)
+		{
+			stats.dropped++;
+			continue;
+		}
+		*buffer = now();
+		sync.Queue_sync.push(buffer);
+	}
+	sync.Queue_sync.push(nullptr);
+	consumer.join();
+
+	stats.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void printStats(const char* name, double rate, RingStats& stats)
+{
+	std::vector<double>& l = stats.latency;
+	std::sort(l.begin(), l.end());
+	auto pct = [&](double p) { return l.empty() ? 0.0 : l.at(std::min(l.size() - 1, (size_t)(p * l.size()))); };
+
+	char pace[32];
+	if (rate > 0) sprintf(pace, "%6.0f fps", rate);
+	else sprintf(pace, "unthrottled");
+	printf("  %-18s %s: latency median %7.1f us, p99 %8.1f us, max %8.1f us / %8.0f hand-offs/s, %d dropped\n",
+		name, pace, pct(0.5), pct(0.99), l.empty() ? 0.0 : l.back(), l.size() / stats.elapsed, stats.dropped);
+	fflush(stdout);
+}
+
+
+// Buffer hand-off between two threads at the frame rates of the pipeline (1000 - 5000 fps) and unthrottled:
+// SyncRing with the spin phase, SyncRing parking at once (its single-core setting) & the mutex queue of SyncObject
+int benchRing(const BenchOptions& options)
+{
+	// The frame rates of the pipeline & unthrottled, or the requested rate only
+	std::vector<double> rates = { 1000.0, 2000.0, 5000.0, 0.0 };
+	if (options.rate >= 0)
+		rates.assign(1, options.rate);
+	int n = RING_BENCH_HANDOFFS * options.frames;
+
+	printf("Buffer hand-off: %d hand-offs per case, %d buffers, %u hardware threads%s\n", n, RING_BENCH_BUFFERS,
+		std::thread::hardware_concurrency(), (std::thread::hardware_concurrency() > 1) ? "" : " (the spin phase only delays the consumer)");
+
+	for (double rate : rates)
+	{
+		SyncRing<stamp_t> ring;
+		ring.allocate_queue_buffer(1, 1, RING_BENCH_BUFFERS);
+
+		RingStats spin;
+		ring.spin_count = SYNC_RING_SPIN_COUNT;
+		runRing(ring, n, rate, spin);
+		printStats("SyncRing (spin)", rate, spin);
+
+		RingStats park;
+		ring.spin_count = 0;
+		runRing(ring, n, rate, park);
+		printStats("SyncRing (park)", rate, park);
+
+		SyncObject<stamp_t> sync;
+		sync.allocate_queue_buffer(1, 1, RING_BENCH_BUFFERS);
+
+		RingStats queue;
+		runQueue(sync, n, rate, queue);
+		printStats("SyncObject (mutex)", rate, queue);
+	}
+
+	return 0;
+}
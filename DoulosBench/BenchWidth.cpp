@@ -0,0 +1,117 @@
+#include "Bench.h"
+
+#include <cstdio>
+#include <cfloat>
+#include <cstdlib>
+#include <algorithm>
+
+
+// Maximum & width indices of the 8-lane routine against WidthIndex_32f of each A-line (count of differing A-lines)
+static int compareWidth(LIFETIME& lifetime, const Ipp32f* src, int stride, Ipp32s length, int n_alines, Ipp32f* buf)
+{
+	int n_diff = 0;
+	for (int i0 = 0; i0 + 8 <= n_alines; i0 += 8)
+	{
+		Ipp32s max_idx8[8], width8[8];
+		lifetime.WidthIndex8_32f(src + i0 * stride, stride, 0.5f, length, buf, max_idx8, width8);
+
+		for (int l = 0; l < 8; l++)
+		{
+			Ipp32s max_idx, width;
+			lifetime.WidthIndex_32f(src + (i0 + l) * stride, 0.5f, length, max_idx, width);
+			if ((max_idx != max_idx8[l]) || (width != width8[l]))
+			{
+				if (n_diff < 8)
+					printf("    A-line %d: max %d / %d, width %d / %d\n", i0 + l, max_idx, max_idx8[l], width, width8[l]);
+				n_diff++;
+			}
+		}
+	}
+	return n_diff;
+}
+
+
+// WidthIndex8_32f (batched width search of LIFETIME) against WidthIndex_32f on the filtered pulses of the simulated
+// frames and on edge cases, with the time of each routine
+int benchWidth(const BenchOptions& options)
+{
+	// 1. Filtered pulses of a simulated frame (all four channel windows)
+	std::vector<Uint16Array2> frames;
+	FLIM_PARAMS params;
+	if (!simulateFrames(1, options.jitter, frames, params))
+		return 1;
+
+	FLImProcess flim;
+	flim._params = params;
+	flim._params.upsample_mode = (options.mode >= 0) ? options.mode : UPSAMPLE_FUSED_ROI;
+
+	int alines = frames.front().size(1);
+	FloatArray2 intensity(alines, 4), mean_delay(alines, 4), lifetime(alines, 3);
+	flim(intensity, mean_delay, lifetime, frames.front());
+
+	const RESIZE& resize = flim._resize;
+	int stride = resize.filt_src.size(0);
+	Ipp32s length = resize.pulse_roi_length;
+	Ipp32f* buf = ippsMalloc_32f(8 * std::max(length, 16));
+
+	printf("Width search: %s against WidthIndex_32f, %d A-lines x %d channels, %d samples\n",
+		flimHasAVX2() ? "AVX2 8-lane routine" : "WidthIndex_32f fallback of the 8-lane routine (no AVX2 on this CPU)", alines, params.n_ch, length);
+
+	int n_diff = 0;
+	for (int j = 0; j < params.n_ch; j++)
+		n_diff += compareWidth(flim._lifetime, resize.filtered(j, 0), stride, length, alines, buf);
+	printf("  simulated pulses: %d of %d A-line channels differ\n", n_diff, alines * params.n_ch);
+
+	// 2. Edge cases: ties of the maximum, flat, negative & edge maxima, no crossing after the maximum
+	const int n_case = 16, len = 16;
+	FloatArray2 cases(len, n_case);
+	for (int l = 0; l < n_case; l++)
+		for (int k = 0; k < len; k++)
+			cases(k, l) = 0.0f;
+	for (int k = 0; k < len; k++)
+	{
+		cases(k, 1) = 1.0f; // flat
+		cases(k, 2) = -1.0f - (float)abs(k - 7); // negative
+		cases(k, 3) = (float)(len - k); // maximum at the first sample
+		cases(k, 4) = (float)k; // maximum at the last sample
+		cases(k, 5) = (k >= 5) ? 2.0f : 0.0f; // no crossing after the maximum
+		cases(k, 6) = ((k == 3) || (k == 9)) ? 4.0f : 1.0f; // two equal maxima
+		cases(k, 7) = ((k >= 6) && (k <= 8)) ? 3.0f : 1.4f; // plateau at the threshold
+		cases(k, 8) = -FLT_MAX; // lowest value everywhere
+		cases(k, 9) = (k == 7) ? 1.0f : 0.5f; // samples exactly at the threshold
+		for (int l = 10; l < n_case; l++)
+			cases(k, l) = (float)((k * 37 + l * 11) % 13) - 4.0f; // pseudo-random
+	}
+	int n_edge = compareWidth(flim._lifetime, cases.raw_ptr(), len, len, n_case, buf);
+	printf("  edge cases: %d of %d differ\n", n_edge, n_case);
+
+	// 3. Time of both routines over a frame (all channels; the index sums keep the calls & must agree)
+	Ipp32s max_idx[8], width[8];
+	long long sum_scalar = 0, sum_batch = 0;
+	std::chrono::steady_clock::time_point tick = std::chrono::steady_clock::now();
+	for (int f = 0; f < options.frames; f++)
+		for (int j = 0; j < params.n_ch; j++)
+			for (int i = 0; i < alines; i++)
+			{
+				flim._lifetime.WidthIndex_32f(resize.filtered(j, i), 0.5f, length, max_idx[0], width[0]);
+				sum_scalar += max_idx[0] + width[0];
+			}
+	double ms_scalar = elapsedMs(tick) / options.frames;
+
+	tick = std::chrono::steady_clock::now();
+	for (int f = 0; f < options.frames; f++)
+		for (int j = 0; j < params.n_ch; j++)
+			for (int i0 = 0; i0 + 8 <= alines; i0 += 8)
+			{
+				flim._lifetime.WidthIndex8_32f(resize.filtered(j, i0), stride, 0.5f, length, buf, max_idx, width);
+				for (int l = 0; l < 8; l++)
+					sum_batch += max_idx[l] + width[l];
+			}
+	double ms_batch = elapsedMs(tick) / options.frames;
+
+	printf("  WidthIndex_32f %.3f ms/frame, WidthIndex8_32f %.3f ms/frame (x%.2f), index sums %s\n",
+		ms_scalar, ms_batch, ms_scalar / ms_batch, (sum_scalar == sum_batch) ? "equal" : "DIFFER");
+
+	ippsFree(buf);
+	return ((n_diff == 0) && (n_edge == 0) && (sum_scalar == sum_batch)) ? 0 : 1;
+}
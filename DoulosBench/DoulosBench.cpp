@@ -0,0 +1,79 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+
+#include "Bench.h"
+
+#include <cstdio>
+#include <algorithm>
+
+#include <tbb/task_arena.h>
+
+
+// Benchmarks & regression checks of the processing pipeline on the frames of the DAQ simulator (no hardware, no display)
+// usage: DoulosBench [options] <bench>
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+	QCoreApplication::setApplicationName("DoulosBench");
+	QCoreApplication::setApplicationVersion(VERSION);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Benchmarks & regression checks on the synthetic frames of the DAQ simulator:\n"
+		"  flim      FLIm processing rate of each up-sampling mode (lifetimes against the MKL spline mode)\n"
+		"  jitter    lifetimes of the jitter compensation against the rotate version (--jitter 4 for whole-sample shifts)\n"
+		"  width     indices of the batched width search (WidthIndex8_32f) against WidthIndex_32f\n"
+		"  ring      buffer hand-off latency & throughput of SyncRing (spin & park) and SyncObject at 1000 - 5000 fps\n"
+		"  pipeline  streaming path of the acquisition tab: simulator, processing workers & in-order visualization");
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("bench", "Benchmark to run.", "<bench>");
+
+	QCommandLineOption framesOption(QStringList() << "n" << "frames", "Timed frames per case.", "n", QString::number(BenchOptions().frames));
+	QCommandLineOption modeOption(QStringList() << "m" << "mode", "FLIm up-sampling mode (-1: every mode).", "mode", "-1");
+	QCommandLineOption jitterOption("jitter", "Simulated trigger jitter (peak-to-peak) [samples].", "samples", QString::number(BenchOptions().jitter));
+	QCommandLineOption rateOption("rate", "Hand-off rate of the ring bench (0: unthrottled, -1: 1000, 2000, 5000 fps & unthrottled), frame rate of the pipeline bench (<= 0: free-running).", "fps", "-1");
+	QCommandLineOption jobsOption(QStringList() << "j" << "jobs", "Worker threads (0: all cores).", "n", "0");
+	parser.addOption(framesOption);
+	parser.addOption(modeOption);
+	parser.addOption(jitterOption);
+	parser.addOption(rateOption);
+	parser.addOption(jobsOption);
+	parser.process(a);
+
+	if (parser.positionalArguments().size() != 1)
+		parser.showHelp(1);
+
+	// 1. Options
+	BenchOptions options;
+	options.frames = std::max(1, parser.value(framesOption).toInt());
+	options.mode = parser.value(modeOption).toInt();
+	options.jitter = parser.value(jitterOption).toFloat();
+	options.rate = parser.value(rateOption).toFloat();
+
+	// 2. Bench (the parallel loops of the processing run in an arena of the requested size)
+	QString bench = parser.positionalArguments().front();
+	int jobs = parser.value(jobsOption).toInt();
+	tbb::task_arena arena(jobs > 0 ? jobs : tbb::task_arena::automatic);
+
+	int ret = -1;
+	arena.execute([&]() {
+		if (bench == "flim")
+			ret = benchFlim(options);
+		else if (bench == "jitter")
+			ret = benchJitter(options);
+		else if (bench == "width")
+			ret = benchWidth(options);
+		else if (bench == "ring")
+			ret = benchRing(options);
+		else if (bench == "pipeline")
+			ret = benchPipeline(options);
+	});
+
+	if (ret < 0)
+	{
+		fprintf(stderr, "Unknown bench: %s\n", bench.toLocal8Bit().constData());
+		parser.showHelp(1);
+	}
+
+	return ret;
+}
@@ -0,0 +1,277 @@
+#include "FlimContainer.h"
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+
+#include <cstring>
+
+
+// Codec /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// 1. Byte shuffle: byte k of every float goes to lane k, so the sign/exponent lanes of a plane become long runs
+//    (zero background of the sparse lifetime maps, nearly constant exponents of the intensity maps).
+// 2. Run-length coding of the shuffled bytes (PackBits style):
+//    control c < 128: c + 1 literal bytes follow / c >= 128: the next byte repeats c - 125 times (3 ~ 130).
+
+void flim_encode_shuffle_rle(const float* src, int n, std::vector<uint8_t>& dst)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+	size_t total = sizeof(float) * (size_t)n;
+
+	std::vector<uint8_t> shuffled(total);
+	for (int i = 0; i < n; i++)
+		for (int k = 0; k < (int)sizeof(float); k++)
+			shuffled[k * (size_t)n + i] = bytes[sizeof(float) * (size_t)i + k];
+
+	dst.clear();
+	dst.reserve(total + total / 128 + 1);
+
+	size_t i = 0;
+	while (i < total)
+	{
+		// Run of the same byte
+		size_t run = 1;
+		while ((i + run < total) && (run < 130) && (shuffled[i + run] == shuffled[i]))
+			run++;
+
+		if (run >= 3)
+		{
+			dst.push_back((uint8_t)(run + 125));
+			dst.push_back(shuffled[i]);
+			i += run;
+			continue;
+		}
+
+		// Literals up to the next run of 3
+		size_t start = i, len = 0;
+		while ((i < total) && (len < 128))
+		{
+			if ((i + 2 < total) && (shuffled[i] == shuffled[i + 1]) && (shuffled[i] == shuffled[i + 2]))
+				break;
+			i++; len++;
+		}
+		dst.push_back((uint8_t)(len - 1));
+		dst.insert(dst.end(), shuffled.begin() + start, shuffled.begin() + start + len);
+	}
+}
+
+bool flim_decode_shuffle_rle(const uint8_t* src, size_t size, float* dst, int n)
+{
+	size_t total = sizeof(float) * (size_t)n;
+	std::vector<uint8_t> shuffled(total);
+
+	size_t i = 0, o = 0;
+	while (i < size)
+	{
+		uint8_t c = src[i++];
+		if (c < 128)
+		{
+			size_t len = (size_t)c + 1;
+			if ((i + len > size) || (o + len > total)) return false;
+			memcpy(&shuffled[o], src + i, len);
+			i += len; o += len;
+		}
+		else
+		{
+			size_t len = (size_t)c - 125;
+			if ((i >= size) || (o + len > total)) return false;
+			memset(&shuffled[o], src[i++], len);
+			o += len;
+		}
+	}
+	if (o != total) return false;
+
+	uint8_t* bytes = reinterpret_cast<uint8_t*>(dst);
+	for (int j = 0; j < n; j++)
+		for (int k = 0; k < (int)sizeof(float); k++)
+			bytes[sizeof(float) * (size_t)j + k] = shuffled[k * (size_t)n + j];
+
+	return true;
+}
+
+
+// Writer ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FlimContainerWriter::FlimContainerWriter() :
+	raw_bytes(0), stored_bytes(0)
+{
+	memset(&header, 0, sizeof(FlimContainerHeader));
+}
+
+FlimContainerWriter::~FlimContainerWriter()
+{
+	if (file.isOpen())
+		close();
+}
+
+bool FlimContainerWriter::open(const QString& path, int image_size, int planes, const QByteArray& config, int codec)
+{
+	file.setFileName(path);
+	if (!file.open(QIODevice::WriteOnly))
+		return false;
+
+	memset(&header, 0, sizeof(FlimContainerHeader));
+	header.magic = FLIM_CONTAINER_MAGIC;
+	header.version = FLIM_CONTAINER_VERSION;
+	header.config_size = (uint32_t)config.size();
+	header.header_size = (uint32_t)sizeof(FlimContainerHeader) + header.config_size;
+	header.image_size = image_size;
+	header.planes = planes;
+	header.codec = codec;
+
+	index.clear();
+	chunks.resize(planes);
+	raw_bytes = stored_bytes = header.header_size;
+
+	// The header is completed on close
+	return (file.write(reinterpret_cast<const char*>(&header), sizeof(FlimContainerHeader)) == sizeof(FlimContainerHeader))
+		&& (file.write(config) == config.size());
+}
+
+bool FlimContainerWriter::writeFrame(const float* frame)
+{
+	int n = header.image_size * header.image_size;
+	uint32_t plane_bytes = (uint32_t)(sizeof(float) * n);
+
+	// Planes are encoded in parallel, then written in order
+	if (header.codec == FLIM_CODEC_SHUFFLE_RLE)
+	{
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, (size_t)header.planes),
+			[&](const tbb::blocked_range<size_t>& r) {
+			for (size_t p = r.begin(); p != r.end(); ++p)
+				flim_encode_shuffle_rle(frame + p * n, n, chunks[p]);
+		});
+	}
+
+	for (int p = 0; p < header.planes; p++)
+	{
+		FlimChunkEntry entry;
+		entry.offset = file.pos();
+
+		// Stored as is unless the codec makes it smaller
+		const char* data = reinterpret_cast<const char*>(frame + (size_t)p * n);
+		entry.stored_size = plane_bytes;
+		entry.codec = FLIM_CODEC_NONE;
+		if ((header.codec == FLIM_CODEC_SHUFFLE_RLE) && (chunks[p].size() < plane_bytes))
+		{
+			data = reinterpret_cast<const char*>(chunks[p].data());
+			entry.stored_size = (uint32_t)chunks[p].size();
+			entry.codec = FLIM_CODEC_SHUFFLE_RLE;
+		}
+
+		if (file.write(data, entry.stored_size) != entry.stored_size)
+			return false;
+
+		index.push_back(entry);
+		raw_bytes += plane_bytes;
+		stored_bytes += entry.stored_size;
+	}
+	header.frames++;
+
+	return true;
+}
+
+bool FlimContainerWriter::close()
+{
+	if (!file.isOpen())
+		return false;
+
+	// Chunk index & completed header
+	header.index_offset = file.pos();
+	qint64 index_size = (qint64)(sizeof(FlimChunkEntry) * index.size());
+	bool ok = (file.write(reinterpret_cast<const char*>(index.data()), index_size) == index_size)
+		&& file.seek(0) && (file.write(reinterpret_cast<const char*>(&header), sizeof(FlimContainerHeader)) == sizeof(FlimContainerHeader));
+	stored_bytes += index_size;
+
+	file.close();
+	std::vector<FlimChunkEntry> clear_index;
+	clear_index.swap(index);
+
+	return ok;
+}
+
+
+// Reader ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+FlimContainerReader::FlimContainerReader()
+{
+	memset(&header, 0, sizeof(FlimContainerHeader));
+}
+
+FlimContainerReader::~FlimContainerReader()
+{
+	close();
+}
+
+bool FlimContainerReader::open(const QString& path)
+{
+	close();
+
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	// Header, configuration snapshot & chunk index
+	if ((file.read(reinterpret_cast<char*>(&header), sizeof(FlimContainerHeader)) != sizeof(FlimContainerHeader))
+		|| (header.magic != FLIM_CONTAINER_MAGIC) || (header.version != FLIM_CONTAINER_VERSION)
+		|| (header.image_size <= 0) || (header.planes <= 0) || (header.frames < 0) || (header.index_offset <= 0))
+	{
+		close();
+		return false;
+	}
+
+	config_text = file.read(header.config_size);
+
+	index.resize((size_t)header.frames * header.planes);
+	qint64 index_size = (qint64)(sizeof(FlimChunkEntry) * index.size());
+	if ((config_text.size() != (int)header.config_size) || !file.seek(header.index_offset)
+		|| (file.read(reinterpret_cast<char*>(index.data()), index_size) != index_size))
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void FlimContainerReader::close()
+{
+	if (file.isOpen())
+		file.close();
+	memset(&header, 0, sizeof(FlimContainerHeader));
+	index.clear();
+	config_text.clear();
+}
+
+bool FlimContainerReader::readPlane(int frame, int plane, float* dst)
+{
+	if ((frame < 0) || (frame >= header.frames) || (plane < 0) || (plane >= header.planes))
+		return false;
+
+	int n = header.image_size * header.image_size;
+	const FlimChunkEntry& entry = index[(size_t)frame * header.planes + plane];
+	if (!file.seek(entry.offset))
+		return false;
+
+	switch (entry.codec)
+	{
+	case FLIM_CODEC_NONE:
+		if (entry.stored_size != sizeof(float) * n)
+			return false;
+		return file.read(reinterpret_cast<char*>(dst), entry.stored_size) == entry.stored_size;
+	case FLIM_CODEC_SHUFFLE_RLE:
+		chunk.resize(entry.stored_size);
+		if (file.read(reinterpret_cast<char*>(chunk.data()), entry.stored_size) != entry.stored_size)
+			return false;
+		return flim_decode_shuffle_rle(chunk.data(), chunk.size(), dst, n);
+	default:
+		return false;
+	}
+}
+
+bool FlimContainerReader::readFrame(int frame, float* dst)
+{
+	int n = header.image_size * header.image_size;
+	for (int p = 0; p < header.planes; p++)
+		if (!readPlane(frame, p, dst + (size_t)p * n))
+			return false;
+
+	return true;
+}
@@ -0,0 +1,109 @@
+#ifndef FLIM_CONTAINER_H
+#define FLIM_CONTAINER_H
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+#include <vector>
+#include <cstdint>
+
+#define FLIM_CONTAINER_MAGIC		0x4D494C46 // "FLIM"
+#define FLIM_CONTAINER_VERSION		1
+
+// Chunk codecs
+#define FLIM_CODEC_NONE				0
+#define FLIM_CODEC_SHUFFLE_RLE		1 // byte-shuffled float lanes + run-length coding (lossless)
+
+
+// Self-describing container of the recorded FLIm frames (extension: .flim)
+// [FlimContainerHeader][configuration snapshot][chunks ...][chunk index: frames x planes FlimChunkEntry]
+// One chunk holds one image plane (image_size x image_size floats) of one frame, so that any frame/plane is read on its own.
+struct FlimContainerHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t header_size; // bytes before the first chunk
+	uint32_t config_size; // bytes of the configuration snapshot (Doulos.ini text)
+	int32_t image_size; // width & height of a plane
+	int32_t planes; // planes per frame (FlimImageFrame::N_PLANES)
+	int32_t frames;
+	uint32_t codec; // codec requested when writing (each chunk records its own)
+	int64_t index_offset; // position of the chunk index
+	int64_t reserved;
+};
+
+struct FlimChunkEntry
+{
+	int64_t offset;
+	uint32_t stored_size; // bytes in the file
+	uint32_t codec;
+};
+
+static_assert(sizeof(FlimContainerHeader) == 48, "FlimContainerHeader must be packed to 48 bytes.");
+static_assert(sizeof(FlimChunkEntry) == 16, "FlimChunkEntry must be packed to 16 bytes.");
+
+
+class FlimContainerWriter
+{
+public:
+	explicit FlimContainerWriter();
+	virtual ~FlimContainerWriter();
+
+private: // Not to call copy constrcutor and copy assignment operator
+	FlimContainerWriter(const FlimContainerWriter&);
+	FlimContainerWriter& operator=(const FlimContainerWriter&);
+
+public:
+	bool open(const QString& path, int image_size, int planes, const QByteArray& config, int codec = FLIM_CODEC_SHUFFLE_RLE);
+	bool writeFrame(const float* frame); // planes x image_size x image_size floats
+	bool close(); // writes the chunk index & completes the header
+
+	int64_t rawBytes() const { return raw_bytes; }
+	int64_t storedBytes() const { return stored_bytes; }
+
+private:
+	QFile file;
+	FlimContainerHeader header;
+	std::vector<FlimChunkEntry> index;
+	std::vector<std::vector<uint8_t>> chunks; // encoding buffers (one per plane)
+	int64_t raw_bytes, stored_bytes;
+};
+
+
+class FlimContainerReader
+{
+public:
+	explicit FlimContainerReader();
+	virtual ~FlimContainerReader();
+
+private: // Not to call copy constrcutor and copy assignment operator
+	FlimContainerReader(const FlimContainerReader&);
+	FlimContainerReader& operator=(const FlimContainerReader&);
+
+public:
+	bool open(const QString& path);
+	void close();
+
+	int frames() const { return header.frames; }
+	int planes() const { return header.planes; }
+	int imageSize() const { return header.image_size; }
+	const QByteArray& config() const { return config_text; }
+
+	bool readPlane(int frame, int plane, float* dst); // image_size x image_size floats
+	bool readFrame(int frame, float* dst); // planes x image_size x image_size floats
+
+private:
+	QFile file;
+	FlimContainerHeader header;
+	QByteArray config_text;
+	std::vector<FlimChunkEntry> index;
+	std::vector<uint8_t> chunk;
+};
+
+
+// Codec of a plane of n floats (exposed for the readers of other tools)
+void flim_encode_shuffle_rle(const float* src, int n, std::vector<uint8_t>& dst);
+bool flim_decode_shuffle_rle(const uint8_t* src, size_t size, float* dst, int n);
+
+#endif // FLIM_CONTAINER_H
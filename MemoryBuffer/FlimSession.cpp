@@ -0,0 +1,128 @@
+#include "FlimSession.h"
+
+#include <QSettings>
+#include <QFileInfo>
+
+#include <DataAcquisition/FLImProcess/FlimFrameResult.h>
+
+
+FlimSession::FlimSession() :
+	n_frames(0), image_size(0), x_step(1), y_step(1),
+	mapped(nullptr), cached_frame(-1)
+{
+}
+
+FlimSession::~FlimSession()
+{
+	close();
+}
+
+
+bool FlimSession::open(const QString& path)
+{
+	close();
+
+	QFileInfo info(path);
+	QString ini = info.absolutePath() + "/" + info.completeBaseName() + ".ini";
+
+	// Configuration saved with the session (stitching tiles, and the geometry of the headerless .data)
+	QSettings settings(ini, QSettings::IniFormat);
+	settings.beginGroup("configuration");
+	x_step = settings.value("imageStichingXStep", 1).toInt();
+	y_step = settings.value("imageStichingYStep", 1).toInt();
+	if (x_step < 1) x_step = 1;
+	if (y_step < 1) y_step = 1;
+
+	if (info.suffix().compare("flim", Qt::CaseInsensitive) == 0)
+	{
+		// 1. Container: geometry from its own header
+		if (!container.open(path) || (container.planes() != FlimImageFrame::N_PLANES))
+		{
+			error = "Not a FLIm container (or an unsupported version).";
+			close();
+			return false;
+		}
+		image_size = container.imageSize();
+		cache = np::FloatArray(FlimImageFrame::length(image_size));
+		n_frames = container.frames();
+	}
+	else
+	{
+		// 2. Raw planes: geometry from the side-car configuration
+		image_size = settings.value("imageSize").toInt();
+		if (image_size <= 0)
+		{
+			error = QString("Image size is not found in %1.").arg(ini);
+			close();
+			return false;
+		}
+
+		file.setFileName(path);
+		qint64 frame_bytes = (qint64)sizeof(float) * FlimImageFrame::length(image_size);
+		if (!file.open(QIODevice::ReadOnly) || (file.size() < frame_bytes))
+		{
+			error = "Failed to open the session (or it has no complete frame).";
+			close();
+			return false;
+		}
+
+		// Copy-on-write mapping: pages are read on demand, and a stray write never reaches the file
+		mapped = file.map(0, file.size(), QFileDevice::MapPrivateOption);
+		if (mapped == nullptr)
+		{
+			error = "Failed to map the session into memory.";
+			close();
+			return false;
+		}
+		n_frames = (int)(file.size() / frame_bytes);
+	}
+	settings.endGroup();
+
+	return true;
+}
+
+void FlimSession::close()
+{
+	if (mapped)
+	{
+		file.unmap(mapped);
+		mapped = nullptr;
+	}
+	if (file.isOpen())
+		file.close();
+	container.close();
+	cache = np::FloatArray();
+	cached_frame = -1;
+	n_frames = 0;
+}
+
+
+np::FloatArray2 FlimSession::intensity(int frame, int ch)
+{
+	return np::FloatArray2(plane(frame, FlimImageFrame::INTENSITY + ch), image_size, image_size);
+}
+
+np::FloatArray2 FlimSession::lifetime(int frame, int ch)
+{
+	return np::FloatArray2(plane(frame, FlimImageFrame::LIFETIME + ch), image_size, image_size);
+}
+
+float* FlimSession::plane(int frame, int plane)
+{
+	if (frame < 0) frame = 0;
+	if (frame >= n_frames) frame = n_frames - 1;
+
+	size_t plane_size = (size_t)image_size * image_size;
+	if (mapped)
+		return reinterpret_cast<float*>(mapped) + ((size_t)frame * FlimImageFrame::N_PLANES + plane) * plane_size;
+
+	// Decode the whole frame once (the channels of a frame are reviewed together)
+	if (frame != cached_frame)
+	{
+		if (!container.readFrame(frame, cache.raw_ptr()))
+			memset(cache.raw_ptr(), 0, sizeof(float) * cache.length());
+		cached_frame = frame;
+	}
+
+	return cache.raw_ptr() + plane * plane_size;
+}
@@ -0,0 +1,59 @@
+#ifndef FLIM_SESSION_H
+#define FLIM_SESSION_H
+
+#include <QString>
+#include <QFile>
+
+#include <Common/array.h>
+
+#include <MemoryBuffer/FlimContainer.h>
+
+
+// Reader of a saved session for offline review
+// .data: the file is memory-mapped (copy-on-write) and the planes are zero-copy views into the mapping,
+//        with the geometry taken from the side-car .ini saved next to it.
+// .flim: the planes of the current frame are decoded into a frame cache.
+class FlimSession
+{
+public:
+	explicit FlimSession();
+	virtual ~FlimSession();
+
+private: // Not to call copy constrcutor and copy assignment operator
+	FlimSession(const FlimSession&);
+	FlimSession& operator=(const FlimSession&);
+
+public:
+	bool open(const QString& path);
+	void close();
+	bool isOpen() const { return n_frames > 0; }
+	const QString& errorString() const { return error; }
+
+	int frames() const { return n_frames; }
+	int imageSize() const { return image_size; }
+	int xStep() const { return x_step; } // stitching tiles of the session (1 if not stitched)
+	int yStep() const { return y_step; }
+
+	// ch: 0 ~ 2 (emission channels), views stay valid until the session is closed (.flim: until another frame is read)
+	np::FloatArray2 intensity(int frame, int ch);
+	np::FloatArray2 lifetime(int frame, int ch);
+
+private:
+	float* plane(int frame, int plane);
+
+private:
+	QString error;
+	int n_frames, image_size;
+	int x_step, y_step;
+
+	// .data
+	QFile file;
+	uchar* mapped;
+
+	// .flim
+	FlimContainerReader container;
+	np::FloatArray cache;
+	int cached_frame;
+};
+
+#endif // FLIM_SESSION_H
@@ -10,6 +10,10 @@
 
 #include <Doulos/Viewer/QImageView.h>
 
+#include <DataAcquisition/FLImProcess/FlimFrameResult.h>
+
+#include <MemoryBuffer/FlimContainer.h>
+
 #include <Common/ImageObject.h>
 #include <Common/medfilt.h>
 
@@ -18,6 +22,11 @@
 #include <chrono>
 #include <mutex>
 #include <condition_variable>
+#include <atomic>
+
+#include <tbb/parallel_for.h>
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
 
 #include <ippcore.h>
 #include <ippi.h>
@@ -27,34 +36,38 @@
 MemoryBuffer::MemoryBuffer(QObject *parent) :
     QObject(parent),
 	m_bIsRecorded(false), m_bIsRecording(false), 
-	m_bIsSaved(false), m_nRecordedFrame(0)
+	m_bIsSaved(false), m_nRecordedFrame(0),
+	m_nWritingBufferSize(0), m_bIsSpooling(false), m_bSpoolError(false)
 {
 	m_pOperationTab = (QOperationTab*)parent;
 	m_pConfig = m_pOperationTab->getStreamTab()->getMainWnd()->m_pConfiguration;
 	m_pDeviceControlTab = m_pOperationTab->getStreamTab()->getDeviceControlTab();
+
+	m_fileSpool.setFileName(QDir::temp().filePath("Doulos_recording.spool"));
 }
 
 MemoryBuffer::~MemoryBuffer()
 {
+	stopRecording();
 	deallocateWritingBuffer();
+	m_fileSpool.remove();
 }
 
 
 void MemoryBuffer::allocateWritingBuffer()
 {	
-	deallocateWritingBuffer();
+	// Only the image size matters (frames are flushed to the spool file as they complete, whatever the stitching tiles)
+	int image_length = FlimImageFrame::length(m_pConfig->imageSize);
+	if (m_nWritingBufferSize == image_length)
+		return;
 
-	int buffer_number = m_pConfig->imageStichingXStep * m_pConfig->imageStichingYStep;
-	for (int i = 0; i < buffer_number; i++)
-	{
-		float *writingImageBuffer = new float[6 * m_pConfig->imageSize * m_pConfig->imageSize];
-		memset(writingImageBuffer, 0, 6 * m_pConfig->imageSize * m_pConfig->imageSize * sizeof(float));
+	deallocateWritingBuffer();
 
-		m_vectorWritingImageBuffer.push_back(writingImageBuffer);
-	}
+	m_syncWritingBuffer.allocate_queue_buffer(image_length, 1, WRITING_BUFFER_SIZE);
+	m_nWritingBufferSize = image_length;
 				
 	char msg[256];
-	sprintf(msg, "Writing buffers are successfully allocated. [Image size: %zd Bytes]", 6 * buffer_number * m_pConfig->imageSize * m_pConfig->imageSize * sizeof(float));
+	sprintf(msg, "Writing buffers are successfully allocated. [Image size: %zd Bytes x %d]", image_length * sizeof(float), WRITING_BUFFER_SIZE);
 	SendStatusMessage(msg, false); 
 	SendStatusMessage("Now, recording process is available!", false);
 
@@ -63,19 +76,11 @@ void MemoryBuffer::allocateWritingBuffer()
 
 void MemoryBuffer::deallocateWritingBuffer()
 {
-	if (m_vectorWritingImageBuffer.size() > 0)
-	{
-		for (int i = 0; i < m_vectorWritingImageBuffer.size(); i++)
-		{
-			if (m_vectorWritingImageBuffer.at(i))
-			{
-				delete[] m_vectorWritingImageBuffer.at(i);
-				m_vectorWritingImageBuffer.at(i) = nullptr;
-			}
-		}
-	}
-	std::vector<float*> clear_vector;
-	clear_vector.swap(m_vectorWritingImageBuffer);
+	if (m_nWritingBufferSize == 0)
+		return;
+
+	m_syncWritingBuffer.deallocate_queue_buffer();
+	m_nWritingBufferSize = 0;
 
 	SendStatusMessage("Writing buffers are successfully disallocated.", false);
 }
@@ -114,6 +119,16 @@ bool MemoryBuffer::startRecording()
 	m_bIsRecorded = false;
 		
 	// Start Recording
+	allocateWritingBuffer();
+	if (!m_fileSpool.open(QIODevice::WriteOnly))
+	{
+		SendStatusMessage("Failed to open the recording spool file.", true);
+		return false;
+	}
+	m_bSpoolError = false;
+	m_bIsSpooling = true;
+	m_threadSpool = std::thread(&MemoryBuffer::spool, this);
+
 	m_nRecordedFrame = 0;
 	m_bIsRecording = true;
 	m_bIsSaved = false;
@@ -158,11 +173,29 @@ void MemoryBuffer::stopRecording()
 {
 	// Stop recording
 	m_bIsRecording = false;
+
+	// Flush the queued frames & close the spool file
+	{
+		std::unique_lock<std::mutex> lock(m_mtxSpool); // no frame is being pushed after this
+		if (!m_bIsSpooling)
+			return;
+		m_bIsSpooling = false;
+	}
+	m_syncWritingBuffer.stop();
+	if (m_threadSpool.joinable())
+		m_threadSpool.join();
+	m_fileSpool.close();
+
+	if (m_bSpoolError)
+	{
+		SendStatusMessage("Error occurred while spooling the recorded frames...", true);
+		m_bIsRecorded = false;
+	}
 		
 	if (m_bIsRecorded) // Not allowed when 'discard'
 	{
 		// Status update
-        uint64_t total_size = (uint64_t)(6 * m_nRecordedFrame * m_pConfig->imageSize * m_pConfig->imageSize * sizeof(float)) / (uint64_t)1024;
+        uint64_t total_size = (uint64_t)(m_nRecordedFrame * FlimImageFrame::length(m_pConfig->imageSize) * sizeof(float)) / (uint64_t)1024;
 		
 		char msg[256];
 		sprintf(msg, "Data recording is finished normally. \n(Recorded frames: %d frames (%.2f MB)", m_nRecordedFrame, (double)total_size / 1024.0);
@@ -170,10 +203,50 @@ void MemoryBuffer::stopRecording()
 	}
 }
 
+bool MemoryBuffer::pushImage(const std::vector<np::FloatArray2>& intensity, const std::vector<np::FloatArray2>& lifetime)
+{
+	std::unique_lock<std::mutex> lock(m_mtxSpool);
+	if (!m_bIsSpooling)
+		return false;
+
+	// Get buffer from writing queue (waits for the spool thread when all of them are in flight)
+	float* image_ptr = m_syncWritingBuffer.wait_buffer(WRITING_BUFFER_TIMEOUT);
+	if (image_ptr == nullptr)
+	{
+		SendStatusMessage("Recorded frame is not taken: the spool file is not keeping up.", false);
+		return false;
+	}
+
+	// Body (Copying the frame data)
+	FlimImageFrame image(image_ptr, m_pConfig->imageSize);
+	for (int i = 0; i < 3; i++)
+	{
+		memcpy(image.intensity(i), intensity.at(i).raw_ptr(), sizeof(float) * intensity.at(i).length());
+		memcpy(image.lifetime(i), lifetime.at(i).raw_ptr(), sizeof(float) * lifetime.at(i).length());
+	}
+	m_syncWritingBuffer.push(image_ptr);
+	m_nRecordedFrame++;
+
+	return true;
+}
+
+void MemoryBuffer::spool()
+{
+	qint64 bytesToWrite = sizeof(float) * m_nWritingBufferSize;
+
+	float* image_ptr;
+	while ((image_ptr = m_syncWritingBuffer.pop()) != nullptr)
+	{
+		if (!m_bSpoolError)
+			m_bSpoolError = m_fileSpool.write(reinterpret_cast<const char*>(image_ptr), bytesToWrite) != bytesToWrite;
+		m_syncWritingBuffer.return_buffer(image_ptr);
+	}
+}
+
 bool MemoryBuffer::startSaving()
 {
 	// Get path to write
-	m_fileName = QFileDialog::getSaveFileName(nullptr, "Save As", "", "FLIm raw data (*.data)");
+	m_fileName = QFileDialog::getSaveFileName(nullptr, "Save As", "", "FLIm raw data (*.data);;FLIm container (*.flim)");
 	if (m_fileName == "") return false;
 	
 	// Start writing thread
@@ -207,10 +280,29 @@ bool MemoryBuffer::startSaving()
 //}
 
 
+// Per-worker scratch of the scaled image export (image objects & median filter are reused across the tasks)
+struct ExportScratch
+{
+	ExportScratch(int image_size, int lifetime_colortable) :
+		intensity(image_size, image_size, ColorTable().m_colorTableVector.at(INTENSITY_COLORTABLE)),
+		lifetime(image_size, image_size, ColorTable().m_colorTableVector.at(lifetime_colortable)),
+		temp(image_size, image_size, ColorTable().m_colorTableVector.at(ColorTable::gray)),
+		merged(image_size, image_size, ColorTable().m_colorTableVector.at(lifetime_colortable)),
+		filter(image_size, image_size, 3, 3)
+	{
+	}
+
+	ImageObject intensity;
+	ImageObject lifetime;
+	ImageObject temp;
+	ImageObject merged;
+	medfilt filter;
+};
+
 void MemoryBuffer::write()
 {	
 	qint64 res;
-    qint64 samplesToWrite = 6 * m_pConfig->imageSize * m_pConfig->imageSize;
+    qint64 samplesToWrite = FlimImageFrame::length(m_pConfig->imageSize);
 
 	if (QFile::exists(m_fileName))
 	{
@@ -226,87 +318,121 @@ void MemoryBuffer::write()
 		if (m_fileName.at(i) == QChar('/')) filePath = m_fileName.left(i);
 	}
 
-	// Writing
+	// Recorded frames (mapped from the spool file, paged in as they are written out)
+	QFile spool(m_fileSpool.fileName());
+	uchar* spool_ptr = nullptr;
+	if (spool.open(QIODevice::ReadOnly) && (spool.size() >= (qint64)sizeof(float) * samplesToWrite * m_nRecordedFrame))
+		spool_ptr = spool.map(0, spool.size());
+	if (spool_ptr == nullptr)
+	{
+		SendStatusMessage("Error occurred while reading the recorded frames...", true);
+		emit finishedWritingThread(true);
+		return;
+	}
+
+	std::vector<float*> frames;
+	for (int i = 0; i < m_nRecordedFrame; i++)
+		frames.push_back(reinterpret_cast<float*>(spool_ptr) + i * samplesToWrite);
+
+	// Writing (.flim: self-describing container, otherwise: headerless planes)
 	QFile file(m_fileName);
-	if (file.open(QIODevice::WriteOnly))
+	bool is_container = m_fileName.endsWith(".flim", Qt::CaseInsensitive);
+	if (is_container || file.open(QIODevice::WriteOnly))
 	{
-		for (int i = 0; i < m_nRecordedFrame; i++)
+		if (is_container)
 		{
-			// FLIm raw image writing		
-			res = file.write(reinterpret_cast<char*>(m_vectorWritingImageBuffer.at(i)), sizeof(float) * samplesToWrite);
-			if (!(res == sizeof(float) * samplesToWrite))
+			// FLIm container writing
+			if (!writeContainer(frames))
 			{
 				SendStatusMessage("Error occurred while writing...", true);
 				emit finishedWritingThread(true);
 				return;
 			}
 		}
-		file.close();
+		else
+		{
+			for (int i = 0; i < m_nRecordedFrame; i++)
+			{
+				// FLIm raw image writing		
+				res = file.write(reinterpret_cast<char*>(frames.at(i)), sizeof(float) * samplesToWrite);
+				if (!(res == sizeof(float) * samplesToWrite))
+				{
+					SendStatusMessage("Error occurred while writing...", true);
+					emit finishedWritingThread(true);
+					return;
+				}
+			}
+			file.close();
+		}
 		
 		QString path = filePath + QString("/scaled_image/");
 		QDir().mkpath(path);
-		for (int i = 0; i < m_nRecordedFrame; i++)
-		{
-			// FLIm scaled image writing
-			ColorTable temp_ctable;
-			IppiSize roi_flim = { m_pConfig->imageSize, m_pConfig->imageSize };
 
-			ImageObject imgObjIntensity(roi_flim.width, roi_flim.height, temp_ctable.m_colorTableVector.at(INTENSITY_COLORTABLE));
-			ImageObject imgObjLifetime(roi_flim.width, roi_flim.height, temp_ctable.m_colorTableVector.at(m_pConfig->flimLifetimeColorTable));
-			ImageObject imgObjTemp(roi_flim.width, roi_flim.height, temp_ctable.m_colorTableVector.at(ColorTable::gray));
-			ImageObject imgObjMerged(roi_flim.width, roi_flim.height, temp_ctable.m_colorTableVector.at(m_pConfig->flimLifetimeColorTable));
+		// FLIm scaled image writing (frame x channel tasks, each worker reusing its own image objects)
+		IppiSize roi_flim = { m_pConfig->imageSize, m_pConfig->imageSize };
+		tbb::enumerable_thread_specific<ExportScratch> scratches(m_pConfig->imageSize, m_pConfig->flimLifetimeColorTable);
+		std::atomic<int> n_done(0);
 
-			for (int j = 0; j < 3; j++)
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, (size_t)(3 * m_nRecordedFrame), 1),
+			[&](const tbb::blocked_range<size_t>& r) {
+			ExportScratch& scratch = scratches.local();
+			for (size_t t = r.begin(); t != r.end(); ++t)
 			{
+				int i = (int)t / 3, j = (int)t % 3;
+				FlimImageFrame image(frames.at(i), m_pConfig->imageSize);
+
 				// Intensity image
-				float* scanIntensity = m_vectorWritingImageBuffer.at(i) + (0 + j) * roi_flim.width * roi_flim.width;
-				ippiScale_32f8u_C1R(scanIntensity, sizeof(float) * roi_flim.width, imgObjIntensity.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
+				float* scanIntensity = image.intensity(j);
+				ippiScale_32f8u_C1R(scanIntensity, sizeof(float) * roi_flim.width, scratch.intensity.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
 					roi_flim, m_pConfig->flimIntensityRange[j].min, m_pConfig->flimIntensityRange[j].max);
 				if (m_nRecordedFrame == 1)
-					imgObjIntensity.qindeximg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
+					scratch.intensity.qindeximg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
 						.save(path + QString("intensity_image_ch_%1_avg_%2_[%3 %4]_%5.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 							.arg(m_pConfig->flimIntensityRange[j].min, 2, 'f', 1).arg(m_pConfig->flimIntensityRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
 				else
-					imgObjIntensity.qindeximg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos, 
+					scratch.intensity.qindeximg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos, 
 						m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize - m_pConfig->imageStichingMisSyncPos)
 					.save(path + QString("intensity_image_ch_%1_avg_%2_[%3 %4]_%5.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 						.arg(m_pConfig->flimIntensityRange[j].min, 2, 'f', 1).arg(m_pConfig->flimIntensityRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
 
 				// Lifetime image
-				float* scanLifetime = m_vectorWritingImageBuffer.at(i) + (3 + j) * roi_flim.width * roi_flim.width;
-				ippiScale_32f8u_C1R(scanLifetime, sizeof(float) * roi_flim.width, imgObjLifetime.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
+				float* scanLifetime = image.lifetime(j);
+				ippiScale_32f8u_C1R(scanLifetime, sizeof(float) * roi_flim.width, scratch.lifetime.arr.raw_ptr(), sizeof(uint8_t) * roi_flim.width,
 					roi_flim, m_pConfig->flimLifetimeRange[j].min, m_pConfig->flimLifetimeRange[j].max);
-				(*m_pOperationTab->getStreamTab()->getVisualizationTab()->getMedfilt())(imgObjLifetime.arr.raw_ptr());
+				scratch.filter(scratch.lifetime.arr.raw_ptr());
 				if (m_nRecordedFrame == 1)
-					imgObjLifetime.qindeximg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
+					scratch.lifetime.qindeximg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
 						.save(path + QString("lifetime_image_ch_%1_avg_%2_[%3 %4]_%5.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 							.arg(m_pConfig->flimLifetimeRange[j].min, 2, 'f', 1).arg(m_pConfig->flimLifetimeRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
 				else
-					imgObjLifetime.qindeximg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos,
+					scratch.lifetime.qindeximg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos,
 						m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize - m_pConfig->imageStichingMisSyncPos)
 					.save(path + QString("lifetime_image_ch_%1_avg_%2_[%3 %4]_%5.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 						.arg(m_pConfig->flimLifetimeRange[j].min, 2, 'f', 1).arg(m_pConfig->flimLifetimeRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
 
-				// Merged image
-				imgObjLifetime.convertRgb();
-				memcpy(imgObjTemp.qindeximg.bits(), imgObjIntensity.arr.raw_ptr(), imgObjTemp.qindeximg.byteCount());
-				imgObjTemp.convertRgb();
-				ippsMul_8u_Sfs(imgObjLifetime.qrgbimg.bits(), imgObjTemp.qrgbimg.bits(), imgObjMerged.qrgbimg.bits(), imgObjTemp.qrgbimg.byteCount(), 8);
+				// Merged image (serial conversions: a worker waiting on a nested parallel loop may pick up another task with the same scratch)
+				scratch.lifetime.convertNonScaledRgb();
+				memcpy(scratch.temp.qindeximg.bits(), scratch.intensity.arr.raw_ptr(), scratch.temp.qindeximg.byteCount());
+				scratch.temp.convertNonScaledRgb();
+				ippsMul_8u_Sfs(scratch.lifetime.qrgbimg.bits(), scratch.temp.qrgbimg.bits(), scratch.merged.qrgbimg.bits(), scratch.temp.qrgbimg.byteCount(), 8);
 				if (m_nRecordedFrame == 1)
-					imgObjMerged.qrgbimg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
+					scratch.merged.qrgbimg.copy(m_pConfig->galvoFlyingBack, 0, m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize)
 						.save(path + QString("merged_image_ch_%1_avg_%2_i[%3 %4]_l[%5 %6]_%7.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 							.arg(m_pConfig->flimIntensityRange[j].min, 2, 'f', 1).arg(m_pConfig->flimIntensityRange[j].max, 2, 'f', 1)
 							.arg(m_pConfig->flimLifetimeRange[j].min, 2, 'f', 1).arg(m_pConfig->flimLifetimeRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
 				else
-					imgObjMerged.qrgbimg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos,
+					scratch.merged.qrgbimg.copy(m_pConfig->galvoFlyingBack, m_pConfig->imageStichingMisSyncPos,
 						m_pConfig->imageSize - m_pConfig->galvoFlyingBack, m_pConfig->imageSize - m_pConfig->imageStichingMisSyncPos)
 					.save(path + QString("merged_image_ch_%1_avg_%2_i[%3 %4]_l[%5 %6]_%7.bmp").arg(j + 1).arg(m_pConfig->imageAveragingFrames)
 						.arg(m_pConfig->flimIntensityRange[j].min, 2, 'f', 1).arg(m_pConfig->flimIntensityRange[j].max, 2, 'f', 1)
 						.arg(m_pConfig->flimLifetimeRange[j].min, 2, 'f', 1).arg(m_pConfig->flimLifetimeRange[j].max, 2, 'f', 1).arg(i + 1), "bmp");
-			}
 
-			emit wroteSingleFrame(i);
-		}			
+				// Progress by completed frames
+				int done = ++n_done;
+				if (done % 3 == 0)
+					emit wroteSingleFrame(done / 3 - 1);
+			}
+		});
 	}
 	else
 	{
@@ -336,3 +462,35 @@ void MemoryBuffer::write()
 	sprintf(msg, "[%s]", filename);
 	SendStatusMessage(msg, false);
 }
+
+bool MemoryBuffer::writeContainer(const std::vector<float*>& frames)
+{
+	// Configuration snapshot
+	m_pConfig->setConfigFile("Doulos.ini");
+	QByteArray config;
+	QFile ini("Doulos.ini");
+	if (ini.open(QIODevice::ReadOnly))
+	{
+		config = ini.readAll();
+		ini.close();
+	}
+
+	// Frames (each plane is a chunk)
+	FlimContainerWriter writer;
+	if (!writer.open(m_fileName, m_pConfig->imageSize, FlimImageFrame::N_PLANES, config))
+		return false;
+
+	for (int i = 0; i < (int)frames.size(); i++)
+		if (!writer.writeFrame(frames.at(i)))
+			return false;
+
+	if (!writer.close())
+		return false;
+
+	char msg[256];
+	sprintf(msg, "FLIm container is written. [%.2f MB, %.1f%% of the raw size]", (double)writer.storedBytes() / 1024.0 / 1024.0,
+		100.0 * (double)writer.storedBytes() / (double)writer.rawBytes());
+	SendStatusMessage(msg, false);
+
+	return true;
+}
@@ -2,13 +2,16 @@
 #define MEMORYBUFFER_H
 
 #include <QObject>
+#include <QFile>
 
 #include <iostream>
 #include <thread>
 #include <queue>
 #include <vector>
+#include <mutex>
 
-#include <Common/SyncObject.h>
+#include <Common/array.h>
+#include <Common/SyncRing.h>
 #include <Common/callback.h>
 
 class MainWindow;
@@ -26,13 +29,14 @@ public:
 
 
 public:
-	// Memory allocation function (buffer for writing)
+	// Memory allocation function (recycled buffers for writing)
     void allocateWritingBuffer();
 	void deallocateWritingBuffer();
 
-    // Data recording (transfer streaming data to writing buffer)
+    // Data recording (transfer streaming data to the spool file through the writing buffers)
     bool startRecording();
     void stopRecording();
+	bool pushImage(const std::vector<np::FloatArray2>& intensity, const std::vector<np::FloatArray2>& lifetime);
 
     // Data saving (save wrote data to hard disk)
     bool startSaving();
@@ -49,10 +53,11 @@ public:
 	// General inline function
 	inline void setIsRecorded(bool is_recorded) { m_bIsRecorded = is_recorded; }
 	inline void setIsRecording(bool is_recording) { m_bIsRecording = is_recording; }
-	inline void increaseRecordedFrame() { m_nRecordedFrame++; }
 
 private: // writing threading operation
+	void spool();
 	void write();
+	bool writeContainer(const std::vector<float*>& frames);
 
 signals:
 	void wroteSingleFrame(int);
@@ -74,8 +79,17 @@ public:
 	callback2<const char*, bool> SendStatusMessage;
 	
 public:
-    std::vector<float*> m_vectorWritingImageBuffer; // writing buffer
 	QString m_fileName;
+
+private:
+	// Recycled writing buffers & spool file of the recorded frames (same layout as .data)
+	SyncRing<float> m_syncWritingBuffer;
+	int m_nWritingBufferSize;
+	QFile m_fileSpool;
+	std::thread m_threadSpool;
+	std::mutex m_mtxSpool;
+	bool m_bIsSpooling;
+	bool m_bSpoolError;
 };
 
 #endif // MEMORYBUFFER_H